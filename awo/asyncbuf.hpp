@@ -0,0 +1,498 @@
+#ifndef INCLUDED_AWO_ASYNCBUF_HPP
+#define INCLUDED_AWO_ASYNCBUF_HPP
+
+/*
+Header file "awo/asyncbuf.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+This class template provides a write-behind output stream buffer, so
+that the thread formatting output never waits for write(2) to complete.
+
+It owns a ring of fixed-size buffers and a dedicated writer thread.
+The formatting thread fills the ring (the put area never spanning two
+buffers) while the writer drains it to the file descriptor, in order.
+Characters are handed over whenever a buffer fills and whenever the
+stream is flushed (by std::flush, std::endl, unitbuf, etc.); a flush
+hands over just the characters written so far, and formatting then
+carries on in the same buffer, so a flush merely publishes a position.
+
+Two counters record how many characters have been handed over and how
+many written; neither thread takes a lock to advance them.  Only if
+the writer falls a whole ring behind does the formatting thread have
+to wait (back-pressure).  A thread that finds nothing to do sleeps on
+a condition variable - so a hand-over that finds the writer asleep
+must wake it, at the cost of a mutex and a notification (but never of
+a write(2)); the writer spins briefly before sleeping to make that
+rare while output is flowing.
+
+A simple example:
+
+void log_values( int const fd, std::vector< unsigned > const& values )
+{
+    awo::asyncbuf buffer{ fd };
+    std::ostream out{ &buffer };
+
+    for ( auto const value : values )
+        out << awo::savefmt{} << std::hex << value << std::endl;
+
+    // (destructor of buffer waits for everything to be written)
+}
+
+As with any stream buffer, an instance must only be written to by one
+thread at a time.  The file descriptor is not closed by this class.
+
+This header uses POSIX facilities (write).
+*/
+
+/// @file awo/asyncbuf.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#if __cplusplus <= 201411L
+#error Header file "awo/asyncbuf.hpp" requires at least C++14 capabilities.
+#endif
+
+#include <atomic>       // std::atomic<>{}
+#include <algorithm>    // std::min<>()
+#include <memory>       // std::unique_ptr<>{}
+#include <string>       // std::char_traits<>{}
+#include <thread>       // std::thread{}
+#include <cerrno>       // errno, EINTR
+#include <cstddef>      // std::size_t
+#include <mutex>        // std::mutex{}, std::unique_lock<>{}, std::lock_guard<>{}
+#include <streambuf>    // std::basic_streambuf<>{}
+#include <condition_variable> // std::condition_variable{}
+
+#include <unistd.h>     // ::write()
+
+//============================================================================
+/// This is the namespace in which all Tony Oliver's distributable components reside.
+namespace awo {
+//----------------------------------------------------------------------------
+
+/// Template from which to create write-behind output stream buffers.
+///
+/// @tparam CharT - The character type on which to instantiate this template.
+/// @tparam Traits - The character-traits type on which to instantiate this template
+/// (usually omitted and the char_traits<> default used).
+///
+/// As with awo::basic_mmapbuf<>, characters are written in their in-memory
+/// representation (no code-conversion takes place).
+
+template< typename CharT, typename Traits = std::char_traits< CharT > >
+class basic_asyncbuf : public std::basic_streambuf< CharT, Traits >
+{
+public:
+
+    using char_type   = CharT;
+    using traits_type = Traits;
+    using int_type    = typename Traits::int_type;
+
+private:
+
+    /// The file descriptor to which the writer thread writes.
+    int const file_descriptor;
+
+    /// The number of characters in each buffer of the ring.
+    std::size_t const buffer_size;
+
+    /// The number of buffers in the ring.
+    std::size_t const buffer_count;
+
+    /// Storage for the whole ring of buffers.
+    std::unique_ptr< CharT[] > storage;
+
+    /// The number of characters the put area's start lies beyond that of the ring (ever).
+    std::size_t put_origin{ 0 };
+
+    /// The number of characters handed over to the writer thread (ever).
+    std::atomic< std::size_t > published{ 0 };
+
+    /// The number of characters the writer thread has finished with (ever).
+    std::atomic< std::size_t > drained{ 0 };
+
+    /// Set when the writer thread is to finish once it has drained the ring.
+    std::atomic< bool > stopping{ false };
+
+    /// Set when a write(2) has failed; all later output is then refused.
+    std::atomic< bool > failed{ false };
+
+    /// Set while the corresponding thread is (about to go) asleep.
+    std::atomic< bool > writer_sleeping{ false };
+    std::atomic< bool > filler_sleeping{ false };
+
+    /// Used only to put the threads to sleep, and wake them (so on hand-over only to a sleeping writer).
+    std::mutex sleep_mutex;
+    std::condition_variable writer_wakeup;
+    std::condition_variable filler_wakeup;
+
+    /// The writer thread itself.
+    std::thread writer;
+
+    /// The total number of characters in the ring.
+    std::size_t capacity() const;
+
+    /// The number of characters written to the put area and its predecessors (ever).
+    std::size_t position() const;
+
+    /// Hand everything written so far to the writer thread (keeping the put area).
+    void publish();
+
+    /// Wait (with back-pressure) for room in the ring; make the put area as much of it as one buffer allows.
+    void acquire_next();
+
+    /// Wake the given thread, if it is asleep (or about to be).
+    void wake( std::atomic< bool >& sleeping, std::condition_variable& wakeup );
+
+    /// Sleep until the given condition holds.
+    template< typename Condition >
+    void sleep_until( std::atomic< bool >& sleeping, std::condition_variable& wakeup, Condition condition );
+
+    /// The writer thread's body: drain buffers, in order, until stopped.
+    void drain();
+
+    /// Write the whole of the given characters to the file descriptor.
+    bool write_all( CharT const* first, std::size_t count ) const;
+
+public:
+
+    /// Constructor: starts the writer thread, which will write to the given file descriptor.
+    /// @param fd - The file descriptor to write to (which this object does not close).
+    /// @param size - The number of characters in each buffer.
+    /// @param count - The number of buffers in the ring (at least two).
+    explicit basic_asyncbuf( int fd, std::size_t size = 65536, std::size_t count = 4 );
+
+    /// Objects of this type \a cannot be copy-constructed.
+    basic_asyncbuf( basic_asyncbuf const& ) = delete;
+
+    /// Objects of this type \a cannot be copy-assigned.
+    basic_asyncbuf& operator=( basic_asyncbuf const& ) = delete;
+
+    /// The destructor hands over any remaining output and waits for it to be written.
+    ~basic_asyncbuf() override;
+
+    /// Hand over any remaining output, wait for the writer thread to drain it all, and stop it.
+    /// @return \b this if all output was written; a null pointer if not (or already closed).
+    basic_asyncbuf* close();
+
+    /// Reports whether the writer thread is still accepting output.
+    bool is_open() const;
+
+protected:
+
+    /// Hand over the full put area and continue in the next free part of the ring.
+    int_type overflow( int_type c ) override;
+
+    /// Hand over everything written so far, without waiting for it to be written.
+    int sync() override;
+};
+
+/*------------------------------------------------------*\
+|*  Specialisations for common stream character-types:  *|
+\*------------------------------------------------------*/
+
+/// Pre-declared instantiation and typedef of template \b basic_asyncbuf over the character-type \b char.
+using asyncbuf = basic_asyncbuf< char >;
+
+//----------------------------------------------------------------------------
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+template< typename CharT, typename Traits >
+awo::basic_asyncbuf< CharT, Traits >::
+basic_asyncbuf( int const fd, std::size_t const size, std::size_t const count )
+: file_descriptor{ fd }
+, buffer_size{ size > 0 ? size : 1 }
+, buffer_count{ count > 2 ? count : 2 }
+, storage{ new CharT[ buffer_size * buffer_count ] }
+{
+    // The first buffer of the ring is free from the start.
+    this->setp( storage.get(), storage.get() + buffer_size );
+
+    // Start the writer only once everything it uses is in place.
+    writer = std::thread{ &basic_asyncbuf::drain, this };
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_asyncbuf< CharT, Traits >::
+capacity() const
+{
+    return buffer_size * buffer_count;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_asyncbuf< CharT, Traits >::
+position() const
+{
+    return put_origin + ( this->pptr() - this->pbase() );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_asyncbuf< CharT, Traits >::
+publish()
+{
+    std::size_t const end = position();
+
+    if ( end == published.load( std::memory_order_relaxed ) )
+    {
+        return;
+    }
+
+    // The characters themselves are published along with (before) the count.
+    published.store( end );
+    wake( writer_sleeping, writer_wakeup );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_asyncbuf< CharT, Traits >::
+acquire_next()
+{
+    std::size_t const start = position();
+
+    // There is room once the writer is less than a whole ring behind.
+    auto const has_room = [ this, start ] { return start - drained.load() < capacity(); };
+
+    if ( !has_room() )
+    {
+        sleep_until( filler_sleeping, filler_wakeup, has_room );
+    }
+
+    // Up to the end of this buffer, or of the room the writer has so far left us.
+    std::size_t const offset = start % capacity();
+    std::size_t const room = std::min( buffer_size - offset % buffer_size,
+                                       drained.load() + capacity() - start );
+
+    put_origin = start;
+    this->setp( storage.get() + offset, storage.get() + offset + room );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_asyncbuf< CharT, Traits >::
+wake( std::atomic< bool >& sleeping, std::condition_variable& wakeup )
+{
+    // Either the sleeper sees our (already published) change before sleeping, or we see it sleeping.
+    if ( sleeping.load() )
+    {
+        std::lock_guard< std::mutex > const lock{ sleep_mutex };
+        wakeup.notify_one();
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename Condition >
+void
+awo::basic_asyncbuf< CharT, Traits >::
+sleep_until( std::atomic< bool >& sleeping, std::condition_variable& wakeup, Condition condition )
+{
+    // Briefly give the other thread the chance to make progress before paying for a sleep (and wake).
+    for ( int attempt = 0; attempt < 64; ++attempt )
+    {
+        if ( condition() ) return;
+        std::this_thread::yield();
+    }
+
+    std::unique_lock< std::mutex > lock{ sleep_mutex };
+
+    sleeping.store( true );
+    wakeup.wait( lock, condition );
+    sleeping.store( false );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_asyncbuf< CharT, Traits >::
+drain()
+{
+    for ( std::size_t written = 0; ; )
+    {
+        auto const is_ready = [ this, written ] { return published.load() != written || stopping.load(); };
+
+        if ( !is_ready() )
+        {
+            sleep_until( writer_sleeping, writer_wakeup, is_ready );
+        }
+
+        std::size_t const end = published.load();
+
+        if ( end == written )
+        {
+            return; // stopping, and everything handed over has been written
+        }
+
+        // Everything published so far, in (at most two) contiguous runs of the ring.
+        while ( written != end )
+        {
+            std::size_t const offset = written % capacity();
+            std::size_t const count = std::min( end - written, capacity() - offset );
+
+            // Once a write has failed, keep draining (so the filler never blocks) but write no more.
+            if ( !failed.load( std::memory_order_relaxed )
+              && !write_all( storage.get() + offset, count ) )
+            {
+                failed.store( true );
+            }
+
+            written += count;
+            drained.store( written );
+            wake( filler_sleeping, filler_wakeup );
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+bool
+awo::basic_asyncbuf< CharT, Traits >::
+write_all( CharT const* const first, std::size_t const count ) const
+{
+    char const* next = reinterpret_cast< char const* >( first );
+    std::size_t remaining = count * sizeof( CharT );
+
+    while ( remaining > 0 )
+    {
+        auto const written = ::write( file_descriptor, next, remaining );
+
+        if ( written < 0 && errno == EINTR )
+        {
+            continue;
+        }
+
+        if ( written <= 0 )
+        {
+            return false;
+        }
+
+        next += written;
+        remaining -= written;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_asyncbuf< CharT, Traits >::
+overflow( int_type const c ) -> int_type
+{
+    if ( !is_open() || failed.load( std::memory_order_relaxed ) )
+    {
+        return Traits::eof();
+    }
+
+    if ( Traits::eq_int_type( c, Traits::eof() ) )
+    {
+        return Traits::not_eof( c );
+    }
+
+    if ( this->pptr() == this->epptr() )
+    {
+        publish();
+        acquire_next();
+    }
+
+    *this->pptr() = Traits::to_char_type( c );
+    this->pbump( 1 );
+
+    return c;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+int
+awo::basic_asyncbuf< CharT, Traits >::
+sync()
+{
+    if ( is_open() )
+    {
+        publish();
+    }
+
+    // Any failure reported here is that of earlier output: this has only been enqueued.
+    return failed.load( std::memory_order_relaxed ) ? -1 : 0;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+bool
+awo::basic_asyncbuf< CharT, Traits >::
+is_open() const
+{
+    return writer.joinable();
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_asyncbuf< CharT, Traits >::
+close() -> basic_asyncbuf*
+{
+    if ( !is_open() )
+    {
+        return nullptr;
+    }
+
+    // Publish the final characters (with no need for room for more).
+    published.store( position() );
+    this->setp( nullptr, nullptr );
+
+    stopping.store( true );
+    wake( writer_sleeping, writer_wakeup );
+    writer.join();
+
+    return failed.load() ? nullptr : this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+awo::basic_asyncbuf< CharT, Traits >::
+~basic_asyncbuf()
+{
+    // Write out everything handed to us and stop the writer thread.
+    close();
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_ASYNCBUF_HPP
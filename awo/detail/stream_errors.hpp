@@ -0,0 +1,69 @@
+#ifndef INCLUDED_AWO_DETAIL_STREAM_ERRORS_HPP
+#define INCLUDED_AWO_DETAIL_STREAM_ERRORS_HPP
+
+/*
+Header file "awo/detail/stream_errors.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+Internal helpers shared by those awo components which perform formatted
+I/O on a stream's behalf and must therefore report failures in the same
+way as the standard formatted extraction/insertion functions.
+*/
+
+/// @file awo/detail/stream_errors.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#include <ios>          // std::basic_ios<>{}, std::ios_base{}
+
+//============================================================================
+namespace awo {
+namespace detail {
+//----------------------------------------------------------------------------
+
+/// Flag \b badbit after an exception escaped a stream buffer or a locale facet.
+///
+/// Must be called from within a \b catch handler.  As the standard formatted
+/// I/O functions do, the original exception is rethrown only if the stream's
+/// exception mask includes \b badbit (and no ios_base::failure is raised).
+template< typename CharT, typename Traits >
+void absorb_exception( std::basic_ios< CharT, Traits >& stream );
+
+//----------------------------------------------------------------------------
+} // close namespace detail
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+template< typename CharT, typename Traits >
+void
+awo::detail::absorb_exception( std::basic_ios< CharT, Traits >& stream )
+{
+    if ( stream.exceptions() & std::ios_base::badbit )
+    {
+        // The caller wants to know: propagate the original exception, not ios_base::failure.
+        try { stream.setstate( std::ios_base::badbit ); } catch ( std::ios_base::failure const& ) {}
+        throw;
+    }
+
+    stream.setstate( std::ios_base::badbit );
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_DETAIL_STREAM_ERRORS_HPP
@@ -0,0 +1,794 @@
+#ifndef INCLUDED_AWO_FORMATTED_VIEW_HPP
+#define INCLUDED_AWO_FORMATTED_VIEW_HPP
+
+/*
+Header file "awo/formatted_view.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+This class template provides a view of an output stream which carries
+its own formatting parameters (flags, width, precision, fill character
+and locale) and never alters those of the stream itself.
+
+The reason basic_savefmt exists is that a stream's format is shared,
+mutable state: whoever changes it must save and restore it around the
+change.  A formatted_view sidesteps the problem: manipulators inserted
+into the view change only the view's parameters, and values inserted
+into it are formatted according to those and written straight to the
+stream's buffer.  Any number of views may write to one stream, each
+with its own format, at a cost of a few words apiece.
+
+A simple example:
+
+void report( std::ostream& out, unsigned const value )
+{
+    awo::formatted_view< char > view{ out };
+
+    view << "hex: 0x" << std::hex << std::setfill( '0' ) << std::setw( 8 ) << value << std::endl;
+
+    // (out's own formatting parameters have not been touched)
+}
+
+A view starts with the parameters of a newly-constructed stream (decimal,
+width 0, precision 6, space fill) and the stream's locale at the time.
+
+Integers, characters and strings of the stream's character type are
+formatted by the view itself when its locale is the classic "C" locale;
+everything else (floating-point values, bools, other locales, user-
+defined types) goes through a per-thread scratch stream, which is loaded
+with the view's parameters, attached to the target stream's buffer for
+the insertion, and its parameters read back after.  Manipulators which
+only set parameters (std::hex, std::setw, etc.) are applied to the
+scratch stream without attaching it, so they take effect whatever the
+state of the target stream, and without flushing its tied stream.
+*/
+
+/// @file awo/formatted_view.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#if __cplusplus <= 201411L
+#error Header file "awo/formatted_view.hpp" requires at least C++14 capabilities.
+#endif
+
+#include <ios>          // std::basic_ios<>{}, std::ios_base{}, std::streamsize
+#include <iomanip>      // std::setw(), std::setprecision(), std::setfill(), std::setbase(), std::setiosflags()
+#include <locale>       // std::locale{}
+#include <string>       // std::basic_string<>{}, std::char_traits<>{}
+#include <cstddef>      // std::size_t
+#include <memory>       // std::unique_ptr<>{}
+#include <ostream>      // std::basic_ostream<>{}
+#include <utility>      // std::exchange<>()
+#include <algorithm>    // std::min<>(), std::fill_n<>()
+#include <streambuf>    // std::basic_streambuf<>{}
+#include <type_traits>  // std::integral_constant<>{}, std::is_integral<>{}, std::make_unsigned_t<>
+
+#include "detail/stream_errors.hpp"     // awo::detail::absorb_exception<>()
+
+//============================================================================
+/// This is the namespace in which all Tony Oliver's distributable components reside.
+namespace awo {
+//----------------------------------------------------------------------------
+
+/// Template from which to create stream views carrying their own formatting parameters.
+///
+/// @tparam CharT - The character type of the stream viewed.
+/// @tparam Traits - The character-traits type of the stream viewed
+/// (usually omitted and the char_traits<> default used).
+
+template< typename CharT, typename Traits = std::char_traits< CharT > >
+class formatted_view
+{
+public:
+
+    /// The type of stream viewed.
+    using ostream_type = std::basic_ostream< CharT, Traits >;
+
+private:
+
+    /// The type of the basic_ios base of the stream viewed.
+    using ios_type = std::basic_ios< CharT, Traits >;
+
+    /// The stream to whose buffer we write.
+    ostream_type* target;
+
+    /// Our own formatting parameters, as held by std::ios_base.
+    std::ios_base::fmtflags format_flags{ std::ios_base::skipws | std::ios_base::dec };
+    std::streamsize field_width{ 0 };
+    std::streamsize float_precision{ 6 };
+    CharT fill_character;
+    std::locale format_locale;
+
+    /// Whether our locale is the classic one (so that our own formatting kernels apply).
+    bool classic_locale;
+
+    /// Does this type get formatted as an integer (rather than as a bool or character)?
+    template< typename T >
+    using is_integer = std::integral_constant< bool,
+                       std::is_integral< T >::value
+                   && !std::is_same< T, bool >::value
+                   && !std::is_same< T, char >::value
+                   && !std::is_same< T, signed char >::value
+                   && !std::is_same< T, unsigned char >::value
+                   && !std::is_same< T, wchar_t >::value
+                   && !std::is_same< T, char16_t >::value
+                   && !std::is_same< T, char32_t >::value >;
+
+    /// Is this an <iomanip> manipulator that only sets formatting parameters (e.g. std::setw)?
+    template< typename T >
+    using is_parameter_manipulator = std::integral_constant< bool,
+                                     std::is_same< T, decltype( std::setw( 0 ) ) >::value
+                                  || std::is_same< T, decltype( std::setprecision( 0 ) ) >::value
+                                  || std::is_same< T, decltype( std::setbase( 0 ) ) >::value
+                                  || std::is_same< T, decltype( std::setfill( CharT{} ) ) >::value
+                                  || std::is_same< T, decltype( std::setiosflags( std::ios_base::fmtflags{} ) ) >::value
+                                  || std::is_same< T, decltype( std::resetiosflags( std::ios_base::fmtflags{} ) ) >::value >;
+
+    /// Insert any value, dispatching on whether it is an integer.
+    template< typename T >
+    void insert( T const& item );
+
+    /// Insert a single character.
+    void insert( CharT character );
+
+    /// Insert a null-terminated string.
+    void insert( CharT const* text );
+
+    /// Insert a string.
+    void insert( std::basic_string< CharT, Traits > const& text );
+
+    /// Insert an integer, formatting it ourselves if we can.
+    template< typename Int >
+    void insert_value( Int value, std::true_type is_integer );
+
+    /// Insert anything else, via the scratch stream.
+    template< typename T >
+    void insert_value( T const& item, std::false_type is_integer );
+
+    /// Apply a parameter-setting manipulator.
+    template< typename T >
+    void insert_other( T const& item, std::true_type is_parameter_manipulator );
+
+    /// Insert any other value (or apply any other manipulator), via the scratch stream.
+    template< typename T >
+    void insert_other( T const& item, std::false_type is_parameter_manipulator );
+
+    /// Format a non-negative magnitude in the given base, right to left, ending at \a end.
+    template< typename Unsigned >
+    static CharT* format_digits( Unsigned magnitude, unsigned base, bool upper, CharT* end );
+
+    /// Write \a prefix (sign or base) and \a body, padded to the field width; then reset the width.
+    void put_padded( CharT const* prefix, std::size_t prefix_length,
+                     CharT const* body, std::size_t body_length );
+
+    /// Apply an item to the scratch stream, loaded with our parameters and attached to the target's buffer.
+    template< typename T >
+    void through_scratch( T const& item );
+
+    /// Apply a manipulator to the scratch stream, loaded with our parameters but attached to no buffer.
+    template< typename Manipulator >
+    void manipulate( Manipulator const& manipulator );
+
+    /// Run an action on the scratch stream, loaded with our parameters; keep them after if it returns true.
+    template< typename Action >
+    void with_scratch( Action const& action );
+
+public:
+
+    /// Constructor: a view of the given stream, with default formatting parameters and the stream's locale.
+    explicit formatted_view( ostream_type& stream );
+
+    /// Reports the stream viewed.
+    ostream_type& stream() const;
+
+    /// Reports the view's format flags.
+    std::ios_base::fmtflags flags() const;
+
+    /// Replaces the view's format flags. @return the previous flags.
+    std::ios_base::fmtflags flags( std::ios_base::fmtflags flags );
+
+    /// Reports the view's field width (for the next formatted insertion only).
+    std::streamsize width() const;
+
+    /// Sets the view's field width. @return the previous width.
+    std::streamsize width( std::streamsize width );
+
+    /// Reports the view's floating-point precision.
+    std::streamsize precision() const;
+
+    /// Sets the view's floating-point precision. @return the previous precision.
+    std::streamsize precision( std::streamsize precision );
+
+    /// Reports the view's fill character.
+    CharT fill() const;
+
+    /// Sets the view's fill character. @return the previous fill character.
+    CharT fill( CharT fill );
+
+    /// Reports the view's locale.
+    std::locale getloc() const;
+
+    /// Sets the view's locale (but not that of the stream, nor its buffer). @return the previous locale.
+    std::locale imbue( std::locale const& locale );
+
+    /// Format a value (or apply a manipulator) according to the view's parameters.
+    template< typename T >
+    formatted_view& operator<<( T const& item );
+
+    /// Apply a format-flag manipulator (e.g. std::hex) to the view.
+    formatted_view& operator<<( std::ios_base& ( *manipulator )( std::ios_base& ) );
+
+    /// Apply a basic_ios manipulator to the view.
+    formatted_view& operator<<( ios_type& ( *manipulator )( ios_type& ) );
+
+    /// Apply a stream manipulator (e.g. std::endl, std::flush) to the stream itself.
+    formatted_view& operator<<( ostream_type& ( *manipulator )( ostream_type& ) );
+};
+
+//----------------------------------------------------------------------------
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+namespace awo {
+namespace detail {
+
+/// A per-thread stream (without a buffer of its own) through which a view's generic insertions are made.
+template< typename CharT, typename Traits >
+struct scratch_stream
+{
+    std::basic_ostream< CharT, Traits > stream{ nullptr };
+    bool in_use{ false };
+};
+
+/// Detach the scratch stream from the target's buffer (and mark it free) however the insertion ends.
+template< typename CharT, typename Traits >
+struct scratch_guard
+{
+    std::basic_ostream< CharT, Traits >& stream;
+    bool& in_use;
+
+    ~scratch_guard()
+    {
+        stream.rdbuf( nullptr );
+        in_use = false;
+    }
+};
+
+} // close namespace detail
+} // close namespace awo
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+awo::formatted_view< CharT, Traits >::
+formatted_view( ostream_type& stream )
+: target{ &stream }
+, fill_character{ stream.widen( ' ' ) }
+, format_locale{ stream.getloc() }
+, classic_locale{ format_locale == std::locale::classic() }
+{
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::formatted_view< CharT, Traits >::
+stream() const -> ostream_type&
+{
+    return *target;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::ios_base::fmtflags
+awo::formatted_view< CharT, Traits >::
+flags() const
+{
+    return format_flags;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::ios_base::fmtflags
+awo::formatted_view< CharT, Traits >::
+flags( std::ios_base::fmtflags const flags )
+{
+    return std::exchange( format_flags, flags );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::streamsize
+awo::formatted_view< CharT, Traits >::
+width() const
+{
+    return field_width;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::streamsize
+awo::formatted_view< CharT, Traits >::
+width( std::streamsize const width )
+{
+    return std::exchange( field_width, width );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::streamsize
+awo::formatted_view< CharT, Traits >::
+precision() const
+{
+    return float_precision;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::streamsize
+awo::formatted_view< CharT, Traits >::
+precision( std::streamsize const precision )
+{
+    return std::exchange( float_precision, precision );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+CharT
+awo::formatted_view< CharT, Traits >::
+fill() const
+{
+    return fill_character;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+CharT
+awo::formatted_view< CharT, Traits >::
+fill( CharT const fill )
+{
+    return std::exchange( fill_character, fill );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::locale
+awo::formatted_view< CharT, Traits >::
+getloc() const
+{
+    return format_locale;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::locale
+awo::formatted_view< CharT, Traits >::
+imbue( std::locale const& locale )
+{
+    classic_locale = locale == std::locale::classic();
+    return std::exchange( format_locale, locale );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+auto
+awo::formatted_view< CharT, Traits >::
+operator<<( T const& item ) -> formatted_view&
+{
+    insert( item );
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::formatted_view< CharT, Traits >::
+operator<<( std::ios_base& ( *manipulator )( std::ios_base& ) ) -> formatted_view&
+{
+    manipulate( manipulator );
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::formatted_view< CharT, Traits >::
+operator<<( ios_type& ( *manipulator )( ios_type& ) ) -> formatted_view&
+{
+    manipulate( manipulator );
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::formatted_view< CharT, Traits >::
+operator<<( ostream_type& ( *manipulator )( ostream_type& ) ) -> formatted_view&
+{
+    // These (std::endl, std::ends, std::flush) write and flush, but use no formatting parameters.
+    manipulator( *target );
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+void
+awo::formatted_view< CharT, Traits >::
+insert( T const& item )
+{
+    insert_value( item, is_integer< T >{} );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::formatted_view< CharT, Traits >::
+insert( CharT const character )
+{
+    typename ostream_type::sentry const sentry{ *target };
+
+    if ( sentry )
+    {
+        put_padded( nullptr, 0, &character, 1 );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::formatted_view< CharT, Traits >::
+insert( CharT const* const text )
+{
+    if ( text == nullptr )
+    {
+        target->setstate( std::ios_base::badbit ); // as operator<< does
+        return;
+    }
+
+    typename ostream_type::sentry const sentry{ *target };
+
+    if ( sentry )
+    {
+        put_padded( nullptr, 0, text, Traits::length( text ) );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::formatted_view< CharT, Traits >::
+insert( std::basic_string< CharT, Traits > const& text )
+{
+    typename ostream_type::sentry const sentry{ *target };
+
+    if ( sentry )
+    {
+        put_padded( nullptr, 0, text.data(), text.size() );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename Int >
+void
+awo::formatted_view< CharT, Traits >::
+insert_value( Int const value, std::true_type )
+{
+    // Only in the classic locale do we know the digits, signs and (absence of) grouping.
+    if ( !classic_locale )
+    {
+        through_scratch( value );
+        return;
+    }
+
+    typename ostream_type::sentry const sentry{ *target };
+
+    if ( !sentry )
+    {
+        return;
+    }
+
+    using unsigned_type = std::make_unsigned_t< Int >;
+
+    std::ios_base::fmtflags const basefield = format_flags & std::ios_base::basefield;
+    unsigned const base = basefield == std::ios_base::oct ? 8 : basefield == std::ios_base::hex ? 16 : 10;
+    bool const upper = ( format_flags & std::ios_base::uppercase ) != 0;
+    bool const showbase = ( format_flags & std::ios_base::showbase ) != 0;
+
+    // As num_put<> does: only decimal conversions of signed types are signed.
+    bool const negative = base == 10 && value < Int{};
+    unsigned_type const magnitude = negative ? unsigned_type( 0 ) - static_cast< unsigned_type >( value )
+                                             : static_cast< unsigned_type >( value );
+
+    CharT prefix[ 2 ];
+    std::size_t prefix_length = 0;
+
+    // Enough for any integer's octal digits, and an octal base prefix.
+    CharT digits[ sizeof( Int ) * 3 + 2 ];
+    CharT* const end = digits + sizeof digits / sizeof *digits;
+    CharT* first = format_digits( magnitude, base, upper, end );
+
+    if ( negative )
+    {
+        prefix[ prefix_length++ ] = CharT( '-' );
+    }
+    else if ( base == 10 && std::is_signed< Int >::value && ( format_flags & std::ios_base::showpos ) )
+    {
+        prefix[ prefix_length++ ] = CharT( '+' );
+    }
+    else if ( base == 16 && showbase && magnitude != 0 )
+    {
+        prefix[ prefix_length++ ] = CharT( '0' );
+        prefix[ prefix_length++ ] = CharT( upper ? 'X' : 'x' );
+    }
+    else if ( base == 8 && showbase && magnitude != 0 )
+    {
+        // As num_put<> does: internal padding goes after a sign or "0x", but before an octal "0".
+        *--first = CharT( '0' );
+    }
+
+    put_padded( prefix, prefix_length, first, end - first );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+void
+awo::formatted_view< CharT, Traits >::
+insert_value( T const& item, std::false_type )
+{
+    insert_other( item, is_parameter_manipulator< T >{} );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+void
+awo::formatted_view< CharT, Traits >::
+insert_other( T const& item, std::true_type )
+{
+    manipulate( item );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+void
+awo::formatted_view< CharT, Traits >::
+insert_other( T const& item, std::false_type )
+{
+    through_scratch( item );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename Unsigned >
+CharT*
+awo::formatted_view< CharT, Traits >::
+format_digits( Unsigned magnitude, unsigned const base, bool const upper, CharT* end )
+{
+    char const* const symbols = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    do
+    {
+        *--end = CharT( symbols[ magnitude % base ] );
+        magnitude /= base;
+    }
+    while ( magnitude != 0 );
+
+    return end;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::formatted_view< CharT, Traits >::
+put_padded( CharT const* const prefix, std::size_t const prefix_length,
+            CharT const* const body, std::size_t const body_length )
+{
+    std::streamsize const length = prefix_length + body_length;
+    std::streamsize padding = field_width > length ? field_width - length : 0;
+    std::ios_base::fmtflags const adjust = format_flags & std::ios_base::adjustfield;
+    auto* const buffer = target->rdbuf();
+
+    field_width = 0;
+
+    auto const put = [ buffer ]( CharT const* const first, std::streamsize const count )
+    {
+        return count == 0 || buffer->sputn( first, count ) == count;
+    };
+
+    auto const pad = [ this, &put, &padding ]
+    {
+        CharT block[ 64 ];
+        std::fill_n( block, std::min< std::streamsize >( padding, 64 ), fill_character );
+
+        for ( ; padding > 0; padding -= std::min< std::streamsize >( padding, 64 ) )
+        {
+            if ( !put( block, std::min< std::streamsize >( padding, 64 ) ) ) return false;
+        }
+
+        return true;
+    };
+
+    bool written = false;
+
+    try
+    {
+        // Padding goes after (left), between prefix and body (internal) or before (otherwise).
+        written = ( adjust == std::ios_base::left || adjust == std::ios_base::internal || pad() )
+               && put( prefix, prefix_length )
+               && ( adjust != std::ios_base::internal || pad() )
+               && put( body, body_length )
+               && ( adjust != std::ios_base::left || pad() );
+
+        // Honour our own unitbuf (the sentry honours only the stream's).
+        if ( written && ( format_flags & std::ios_base::unitbuf ) )
+        {
+            written = buffer->pubsync() != -1;
+        }
+    }
+    catch ( ... )
+    {
+        detail::absorb_exception( *target );
+    }
+
+    if ( !written )
+    {
+        target->setstate( std::ios_base::badbit );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename T >
+void
+awo::formatted_view< CharT, Traits >::
+through_scratch( T const& item )
+{
+    // Flush any tied stream, and write nothing if the stream is not good (as for direct insertion).
+    typename ostream_type::sentry const sentry{ *target };
+
+    if ( !sentry )
+    {
+        return;
+    }
+
+    std::ios_base::iostate failure = std::ios_base::goodbit;
+
+    with_scratch( [ this, &item, &failure ]( ostream_type& stream )
+    {
+        stream.rdbuf( target->rdbuf() );
+
+        try
+        {
+            stream << item;
+        }
+        catch ( ... )
+        {
+            detail::absorb_exception( *target );
+            return false;
+        }
+
+        failure = stream.rdstate() & ( std::ios_base::badbit | std::ios_base::failbit );
+        return true;
+    } );
+
+    // Report any failure on the stream itself.
+    if ( failure != std::ios_base::goodbit )
+    {
+        target->setstate( failure );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename Manipulator >
+void
+awo::formatted_view< CharT, Traits >::
+manipulate( Manipulator const& manipulator )
+{
+    // No sentry: like the stream's own manipulators, these write nothing, so apply in any state.
+    with_scratch( [ &manipulator ]( ostream_type& stream )
+    {
+        stream << manipulator;
+        return true;
+    } );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+template< typename Action >
+void
+awo::formatted_view< CharT, Traits >::
+with_scratch( Action const& action )
+{
+    static thread_local detail::scratch_stream< CharT, Traits > shared;
+
+    // An insertion may itself use a view (e.g. in a user-defined operator<<): then the
+    // shared scratch stream is busy, so a private one is needed.
+    std::unique_ptr< detail::scratch_stream< CharT, Traits > > const nested{
+        shared.in_use ? new detail::scratch_stream< CharT, Traits > : nullptr };
+    auto& scratch = nested ? *nested : shared;
+
+    ostream_type& stream = scratch.stream;
+
+    // Imbue while the scratch stream has no buffer, so that the target's buffer is left alone.
+    if ( stream.getloc() != format_locale )
+    {
+        stream.imbue( format_locale );
+    }
+
+    stream.flags( format_flags );
+    stream.width( field_width );
+    stream.precision( float_precision );
+    stream.fill( fill_character );
+
+    scratch.in_use = true;
+    detail::scratch_guard< CharT, Traits > const guard{ stream, scratch.in_use };
+
+    if ( !action( stream ) )
+    {
+        return;
+    }
+
+    // Keep whatever the insertion (or manipulator) made of our parameters.
+    format_flags = stream.flags();
+    field_width = stream.width();
+    float_precision = stream.precision();
+    fill_character = stream.fill();
+
+    if ( stream.getloc() != format_locale )
+    {
+        imbue( stream.getloc() );
+    }
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_FORMATTED_VIEW_HPP
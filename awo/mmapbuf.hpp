@@ -0,0 +1,337 @@
+#ifndef INCLUDED_AWO_MMAPBUF_HPP
+#define INCLUDED_AWO_MMAPBUF_HPP
+
+/*
+Header file "awo/mmapbuf.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+This class template provides an output stream buffer whose put area
+is a shared memory-mapping of the file being written.  Characters
+inserted into a stream using it land directly in the page cache:
+there is no intermediate user-space buffer to copy from and no
+write(2) call when the stream is flushed.
+
+The mapping grows geometrically as the put area fills; on close()
+(or destruction) it is unmapped and the file is truncated to the
+number of characters actually written.
+
+A simple example:
+
+void write_report( char const* path, std::vector< unsigned > const& values )
+{
+    awo::mmapbuf buffer;
+    if ( buffer.open( path ) == nullptr ) throw std::runtime_error{ path };
+
+    std::ostream out{ &buffer };
+    for ( auto const value : values )
+        out << awo::savefmt{} << std::hex << std::setw( 8 ) << value << '\n';
+}
+
+The file is an image of the characters held in memory: for character
+types wider than char, that is their in-memory representation (no
+code-conversion takes place, unlike std::basic_filebuf<>).
+
+This header uses POSIX facilities (open, mmap, posix_fallocate, etc.).
+*/
+
+/// @file awo/mmapbuf.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#if __cplusplus <= 201411L
+#error Header file "awo/mmapbuf.hpp" requires at least C++14 capabilities.
+#endif
+
+#include <string>       // std::char_traits<>{}
+#include <climits>      // INT_MAX
+#include <cstddef>      // std::size_t
+#include <utility>      // std::exchange<>()
+#include <streambuf>    // std::basic_streambuf<>{}
+
+#include <fcntl.h>      // ::open(), ::posix_fallocate(), O_*
+#include <unistd.h>     // ::close(), ::ftruncate()
+#include <sys/mman.h>   // ::mmap(), ::munmap(), PROT_*, MAP_*
+#include <sys/types.h>  // off_t
+
+//============================================================================
+/// This is the namespace in which all Tony Oliver's distributable components reside.
+namespace awo {
+//----------------------------------------------------------------------------
+
+/// Template from which to create output stream buffers that write via a memory-mapped file.
+///
+/// @tparam CharT - The character type on which to instantiate this template.
+/// @tparam Traits - The character-traits type on which to instantiate this template
+/// (usually omitted and the char_traits<> default used).
+///
+/// The interface follows that of std::basic_filebuf<> (open(), is_open(), close())
+/// for output only.  Flushing is a no-op: the put area \a is the file's pages.
+
+template< typename CharT, typename Traits = std::char_traits< CharT > >
+class basic_mmapbuf : public std::basic_streambuf< CharT, Traits >
+{
+public:
+
+    using char_type   = CharT;
+    using traits_type = Traits;
+    using int_type    = typename Traits::int_type;
+
+private:
+
+    /// Initial size of the mapping, in characters.
+    static constexpr std::size_t initial_capacity{ ( std::size_t{ 1 } << 20 ) / sizeof( CharT ) };
+
+    /// The file descriptor of the open file; -1 when closed.
+    int file_descriptor{ -1 };
+
+    /// Size of the current mapping (and of the file, while open), in characters.
+    std::size_t capacity{ 0 };
+
+    /// Establish a mapping of the given size, preserving the number of characters already written.
+    bool remap( std::size_t new_capacity );
+
+    /// Position the put pointer \a count characters beyond the start of the put area.
+    void advance( std::size_t count );
+
+public:
+
+    /// Default constructor: creates a closed buffer.
+    basic_mmapbuf() = default;
+
+    /// Objects of this type \a cannot be copy-constructed.
+    basic_mmapbuf( basic_mmapbuf const& ) = delete;
+
+    /// Objects of this type \a cannot be copy-assigned.
+    basic_mmapbuf& operator=( basic_mmapbuf const& ) = delete;
+
+    /// If a file is open, the destructor closes it (truncating it to the written size).
+    ~basic_mmapbuf() override;
+
+    /// Create (or truncate) the named file and map it for writing.
+    /// @return \b this on success; a null pointer if already open or on failure.
+    basic_mmapbuf* open( char const* path );
+
+    /// Reports whether a file is currently open.
+    bool is_open() const;
+
+    /// Unmap the file and truncate it to the number of characters written.
+    /// @return \b this on success; a null pointer if not open or on failure.
+    basic_mmapbuf* close();
+
+protected:
+
+    /// Grow the mapping when the put area is full.
+    int_type overflow( int_type c ) override;
+
+    /// Nothing to do: written characters are already in the page cache.
+    int sync() override;
+};
+
+/*------------------------------------------------------*\
+|*  Specialisations for common stream character-types:  *|
+\*------------------------------------------------------*/
+
+/// Pre-declared instantiation and typedef of template \b basic_mmapbuf over the character-type \b char.
+using mmapbuf = basic_mmapbuf< char >;
+
+//----------------------------------------------------------------------------
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_mmapbuf< CharT, Traits >::
+open( char const* path ) -> basic_mmapbuf*
+{
+    if ( is_open() )
+    {
+        return nullptr;
+    }
+
+    file_descriptor = ::open( path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+
+    if ( file_descriptor < 0 )
+    {
+        return nullptr;
+    }
+
+    if ( !remap( initial_capacity ) )
+    {
+        ::close( std::exchange( file_descriptor, -1 ) );
+        return nullptr;
+    }
+
+    return this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+bool
+awo::basic_mmapbuf< CharT, Traits >::
+is_open() const
+{
+    return file_descriptor >= 0;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_mmapbuf< CharT, Traits >::
+close() -> basic_mmapbuf*
+{
+    if ( !is_open() )
+    {
+        return nullptr;
+    }
+
+    std::size_t const written = this->pptr() - this->pbase();
+    bool succeeded = true;
+
+    // Drop the mapping; the page cache still holds everything written through it.
+    if ( this->pbase() != nullptr && ::munmap( this->pbase(), capacity * sizeof( CharT ) ) != 0 )
+    {
+        succeeded = false;
+    }
+
+    this->setp( nullptr, nullptr );
+    capacity = 0;
+
+    // Discard the unused tail of the last growth step.
+    if ( ::ftruncate( file_descriptor, static_cast< off_t >( written * sizeof( CharT ) ) ) != 0 )
+    {
+        succeeded = false;
+    }
+
+    if ( ::close( std::exchange( file_descriptor, -1 ) ) != 0 )
+    {
+        succeeded = false;
+    }
+
+    return succeeded ? this : nullptr;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+bool
+awo::basic_mmapbuf< CharT, Traits >::
+remap( std::size_t const new_capacity )
+{
+    std::size_t const written = this->pptr() - this->pbase();
+
+    // Reserve the file's blocks up-front: a store into an unbacked page of a
+    // sparse file would raise SIGBUS (e.g. on a full disk) rather than fail here.
+    if ( ::posix_fallocate( file_descriptor, 0, static_cast< off_t >( new_capacity * sizeof( CharT ) ) ) != 0 )
+    {
+        return false;
+    }
+
+    void* const region = ::mmap( nullptr, new_capacity * sizeof( CharT ),
+                                 PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0 );
+
+    if ( region == MAP_FAILED )
+    {
+        return false;
+    }
+
+    if ( this->pbase() != nullptr )
+    {
+        ::munmap( this->pbase(), capacity * sizeof( CharT ) );
+    }
+
+    auto* const first = static_cast< CharT* >( region );
+    this->setp( first, first + new_capacity );
+    advance( written );
+    capacity = new_capacity;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_mmapbuf< CharT, Traits >::
+advance( std::size_t count )
+{
+    // pbump() only takes an int, but multi-gigabyte files are expected here.
+    while ( count > INT_MAX )
+    {
+        this->pbump( INT_MAX );
+        count -= INT_MAX;
+    }
+
+    this->pbump( static_cast< int >( count ) );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_mmapbuf< CharT, Traits >::
+overflow( int_type const c ) -> int_type
+{
+    if ( !is_open() )
+    {
+        return Traits::eof();
+    }
+
+    if ( Traits::eq_int_type( c, Traits::eof() ) )
+    {
+        return Traits::not_eof( c );
+    }
+
+    // Double the mapping, so that the number of remaps is logarithmic in the file size.
+    if ( this->pptr() == this->epptr() && !remap( 2 * capacity ) )
+    {
+        return Traits::eof();
+    }
+
+    *this->pptr() = Traits::to_char_type( c );
+    this->pbump( 1 );
+
+    return c;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+int
+awo::basic_mmapbuf< CharT, Traits >::
+sync()
+{
+    // There is no user-space buffer to drain: the put area is the file's pages.
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+awo::basic_mmapbuf< CharT, Traits >::
+~basic_mmapbuf()
+{
+    // Close any open file (truncating it to the characters written).
+    close();
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_MMAPBUF_HPP
@@ -0,0 +1,464 @@
+#ifndef INCLUDED_AWO_READ_RANGE_HPP
+#define INCLUDED_AWO_READ_RANGE_HPP
+
+/*
+Header file "awo/read_range.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+This function template extracts a whitespace-separated run of numeric
+values from an input stream, passing each one to an output iterator.
+
+It behaves exactly as the familiar element-wise loop
+
+    for ( T value; stream >> value; ) *out++ = value;
+
+but, rather than constructing a sentry and looking up the stream's
+locale facets for every value, it does so once for the whole range
+and then works directly on the stream's buffer.
+
+Integers read in the classic "C" locale with a fixed radix (dec, oct
+or hex) - the common case - are moreover scanned and converted by
+read_range itself, straight from the stream buffer's get area.  A
+value is handed to the locale's num_get<> facet instead whenever the
+characters that decide it are not all in the get area already (i.e.
+it runs up against the end of the buffered input), and for all other
+types, locales and radix settings.
+
+Only stream buffers that keep a get area benefit from that scanning:
+std::stringbuf and std::filebuf do, but (in libstdc++) std::cin's
+buffer, while synchronised with C stdio, does not - it hands over one
+character at a time, so every value goes to num_get<>.  Reading from
+std::cin, call std::ios_base::sync_with_stdio( false ) first (before
+any I/O), or read through a std::ifstream.
+
+A simple example:
+
+void read_hex( std::istream& in, std::vector< unsigned >& values )
+{
+    awo::read_range< unsigned >( in >> awo::savefmt{} >> std::hex,
+                                 std::back_inserter( values ) );
+}
+
+The temporary savefmt lives until the end of the full expression, so
+the values are read in hex and the stream's radix is then restored.
+*/
+
+/// @file awo/read_range.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#if __cplusplus <= 201411L
+#error Header file "awo/read_range.hpp" requires at least C++14 capabilities.
+#endif
+
+#include <ios>          // std::ios_base{}
+#include <limits>       // std::numeric_limits<>{}
+#include <climits>      // INT_MAX
+#include <cstddef>      // std::size_t
+#include <streambuf>    // std::basic_streambuf<>{}
+#include <type_traits>  // std::conditional_t<>, std::is_integral<>{}, std::is_same<>{}, std::make_unsigned_t<>
+#include <locale>       // std::num_get<>{}, std::ctype<>{}, std::use_facet<>()
+#include <istream>      // std::basic_istream<>{}
+#include <iterator>     // std::istreambuf_iterator<>{}
+
+#include "detail/stream_errors.hpp"     // awo::detail::absorb_exception<>()
+
+//============================================================================
+/// This is the namespace in which all Tony Oliver's distributable components reside.
+namespace awo {
+//----------------------------------------------------------------------------
+
+/// Extract successive values of type \b T from a stream until an extraction fails.
+///
+/// Equivalent to <tt>for ( T value; stream >> value; ) *out++ = value;</tt> - including
+/// the values delivered, the stream's final state (which always includes \b failbit,
+/// as the loop's terminating extraction sets it) and the exceptions thrown - but
+/// the sentry is constructed, and the locale's facets looked up, only once.
+///
+/// @tparam T - The arithmetic (non-character) type of the values to be extracted.
+/// @param stream - The stream from which to extract; its current formatting
+/// parameters (radix, \b skipws, locale) govern the whole range.
+/// @param out - The output iterator to which each successfully-extracted value is assigned.
+/// @return the output iterator, advanced past the last value assigned.
+template< typename T, typename CharT, typename Traits, typename OutputIt >
+OutputIt read_range( std::basic_istream< CharT, Traits >& stream, OutputIt out );
+
+//----------------------------------------------------------------------------
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+namespace awo {
+namespace detail {
+
+/// Parse a single value of any type for which std::num_get<> has a direct overload.
+template< typename CharT, typename Iterator, typename T >
+Iterator
+get_number( std::num_get< CharT, Iterator > const& facet,
+            Iterator first, Iterator last,
+            std::ios_base& stream, std::ios_base::iostate& state, T& value )
+{
+    return facet.get( first, last, stream, state, value );
+}
+
+/// Narrow a parsed \b long to a \b short or \b int the way operator>> does: range-checked.
+template< typename Int >
+void narrow_from_long( long const wide_value, std::ios_base::iostate& state, Int& value )
+{
+    if ( wide_value < std::numeric_limits< Int >::min() )
+    {
+        state |= std::ios_base::failbit;
+        value = std::numeric_limits< Int >::min();
+    }
+    else if ( wide_value > std::numeric_limits< Int >::max() )
+    {
+        state |= std::ios_base::failbit;
+        value = std::numeric_limits< Int >::max();
+    }
+    else
+    {
+        value = static_cast< Int >( wide_value );
+    }
+}
+
+/// Parse a \b short or \b int the way operator>> does: via a \b long, then range-checked.
+template< typename Int, typename CharT, typename Iterator >
+Iterator
+get_via_long( std::num_get< CharT, Iterator > const& facet,
+              Iterator first, Iterator last,
+              std::ios_base& stream, std::ios_base::iostate& state, Int& value )
+{
+    long wide_value{};
+    Iterator const next = facet.get( first, last, stream, state, wide_value );
+
+    narrow_from_long( wide_value, state, value );
+
+    return next;
+}
+
+template< typename CharT, typename Iterator >
+Iterator
+get_number( std::num_get< CharT, Iterator > const& facet,
+            Iterator first, Iterator last,
+            std::ios_base& stream, std::ios_base::iostate& state, short& value )
+{
+    return get_via_long( facet, first, last, stream, state, value );
+}
+
+template< typename CharT, typename Iterator >
+Iterator
+get_number( std::num_get< CharT, Iterator > const& facet,
+            Iterator first, Iterator last,
+            std::ios_base& stream, std::ios_base::iostate& state, int& value )
+{
+    return get_via_long( facet, first, last, stream, state, value );
+}
+
+/// Does read_range scan and convert values of this type itself (in the classic locale)?
+template< typename T >
+using is_scannable = std::integral_constant< bool,
+                     std::is_integral< T >::value
+                 && !std::is_same< T, bool >::value
+                 && !std::is_same< T, char >::value
+                 && !std::is_same< T, signed char >::value
+                 && !std::is_same< T, unsigned char >::value
+                 && !std::is_same< T, wchar_t >::value
+                 && !std::is_same< T, char16_t >::value
+                 && !std::is_same< T, char32_t >::value >;
+
+/// The type num_get<> parses a \b T as: \b long for \b short and \b int (as operator>> does).
+template< typename T >
+using parsed_type = std::conditional_t< std::is_same< T, short >::value || std::is_same< T, int >::value, long, T >;
+
+/// Access to a stream buffer's (protected) get-area pointers.
+template< typename CharT, typename Traits >
+struct get_area : std::basic_streambuf< CharT, Traits >
+{
+    using buffer_type = std::basic_streambuf< CharT, Traits >;
+
+    /// The next character to be read.
+    static CharT const* next( buffer_type& buffer )
+    {
+        return ( buffer.*&get_area::gptr )();
+    }
+
+    /// The end of the characters available without a call to underflow().
+    static CharT const* end( buffer_type& buffer )
+    {
+        return ( buffer.*&get_area::egptr )();
+    }
+
+    /// Consume the given number of (available) characters.
+    static void consume( buffer_type& buffer, std::size_t count )
+    {
+        for ( ; count > INT_MAX; count -= INT_MAX ) ( buffer.*&get_area::gbump )( INT_MAX );
+        ( buffer.*&get_area::gbump )( static_cast< int >( count ) );
+    }
+};
+
+/// The value of a digit in the given base (as num_get<> reads it in the classic locale), or -1.
+template< typename CharT, typename Traits >
+int digit_value( CharT const c, unsigned const base )
+{
+    // Looked up, not tested for (so that runs of mixed hex digits and letters cost no mispredictions).
+    static unsigned char const values[ 128 ] =
+    {
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+         0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 99, 99, 99, 99, 99, 99,
+        99, 10, 11, 12, 13, 14, 15, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 10, 11, 12, 13, 14, 15, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    };
+
+    // (Any negative int_type converts to a value well beyond the table.)
+    auto const code = static_cast< unsigned long >( Traits::to_int_type( c ) );
+    unsigned const value = code < 128 ? values[ code ] : 99;
+
+    return value < base ? int( value ) : -1;
+}
+
+/// Scan an integer from [first, last), exactly as num_get<> would in the classic locale
+/// (without grouping); but only if the character that ends it lies within that range.
+/// @return the end of the characters consumed; or null (having changed nothing) if undecided.
+template< typename Int, typename CharT, typename Traits >
+CharT const*
+scan_integer( CharT const* first, CharT const* const last, unsigned const base,
+              std::ios_base::iostate& state, Int& value )
+{
+    using unsigned_type = std::make_unsigned_t< Int >;
+
+    auto const is = [ & ]( char const c ) { return first != last && Traits::eq( *first, CharT( c ) ); };
+
+    // An optional sign (negating even an unsigned value, as num_get<> does)...
+    bool const negative = is( '-' );
+    if ( negative || is( '+' ) ) ++first;
+
+    // ...then, in hex, an optional "0x" or "0X" (which needs a character of look-ahead)...
+    if ( base == 16 && is( '0' ) )
+    {
+        if ( last - first < 2 ) return nullptr;
+        if ( Traits::eq( first[ 1 ], CharT( 'x' ) ) || Traits::eq( first[ 1 ], CharT( 'X' ) ) ) first += 2;
+    }
+
+    // ...then digits, accumulated with num_get<>'s overflow rules (it reads on after overflowing).
+    unsigned_type const max = negative && std::numeric_limits< Int >::is_signed
+                            ? unsigned_type( 0 ) - static_cast< unsigned_type >( std::numeric_limits< Int >::min() )
+                            : static_cast< unsigned_type >( std::numeric_limits< Int >::max() );
+    unsigned_type const scaled_max = max / base;
+    unsigned_type result = 0;
+    bool overflow = false;
+    bool any_digits = false;
+
+    for ( int digit; first != last && ( digit = digit_value< CharT, Traits >( *first, base ) ) >= 0; ++first )
+    {
+        any_digits = true;
+
+        if ( result > scaled_max )
+        {
+            overflow = true;
+        }
+        else
+        {
+            result *= base;
+            overflow |= result > max - unsigned_type( digit );
+            result += unsigned_type( digit );
+        }
+    }
+
+    // The value is only decided by a character that ends it.
+    if ( first == last )
+    {
+        return nullptr;
+    }
+
+    if ( !any_digits )
+    {
+        value = 0;
+        state |= std::ios_base::failbit;
+    }
+    else if ( overflow )
+    {
+        value = negative && std::numeric_limits< Int >::is_signed ? std::numeric_limits< Int >::min()
+                                                                  : std::numeric_limits< Int >::max();
+        state |= std::ios_base::failbit;
+    }
+    else
+    {
+        value = static_cast< Int >( negative ? unsigned_type( 0 ) - result : result );
+    }
+
+    return first;
+}
+
+/// Deliver a parsed value as it was parsed...
+template< typename T >
+void deliver( T const parsed, std::ios_base::iostate&, T& value )
+{
+    value = parsed;
+}
+
+/// ...or range-checked, for a \b short or \b int parsed as a \b long.
+inline void deliver( long const parsed, std::ios_base::iostate& state, short& value )
+{
+    narrow_from_long( parsed, state, value );
+}
+
+inline void deliver( long const parsed, std::ios_base::iostate& state, int& value )
+{
+    narrow_from_long( parsed, state, value );
+}
+
+/// Scan a value from the get area, if read_range can; @return false if num_get<> must be used.
+template< typename T, typename CharT, typename Traits >
+bool
+scan_value( std::basic_streambuf< CharT, Traits >& buffer, unsigned const base,
+            std::ios_base::iostate& state, T& value, std::true_type /* is_scannable */ )
+{
+    using area = get_area< CharT, Traits >;
+
+    CharT const* const first = area::next( buffer );
+    parsed_type< T > parsed{};
+    CharT const* const next = scan_integer< parsed_type< T >, CharT, Traits >( first, area::end( buffer ), base, state, parsed );
+
+    if ( next == nullptr )
+    {
+        return false;
+    }
+
+    area::consume( buffer, next - first );
+    deliver( parsed, state, value );
+
+    return true;
+}
+
+/// Other types are always parsed by num_get<>.
+template< typename T, typename CharT, typename Traits >
+bool
+scan_value( std::basic_streambuf< CharT, Traits >&, unsigned, std::ios_base::iostate&, T&, std::false_type /* is_scannable */ )
+{
+    return false;
+}
+
+} // close namespace detail
+} // close namespace awo
+
+//----------------------------------------------------------------------------
+
+template< typename T, typename CharT, typename Traits, typename OutputIt >
+OutputIt
+awo::read_range( std::basic_istream< CharT, Traits >& stream, OutputIt out )
+{
+    using istream_type  = std::basic_istream< CharT, Traits >;
+    using iterator_type = std::istreambuf_iterator< CharT, Traits >;
+    using num_get_type  = std::num_get< CharT, iterator_type >;
+
+    // A single sentry serves the whole range: it flushes any tied stream and skips
+    // leading whitespace (setting failbit and eofbit itself if it runs out of input).
+    typename istream_type::sentry const sentry{ stream };
+
+    if ( !sentry )
+    {
+        return out;
+    }
+
+    // Everything an element-wise extraction would look up per value, looked up once.
+    std::locale const locale{ stream.getloc() };
+    num_get_type const& numeric = std::use_facet< num_get_type >( locale );
+    std::ctype< CharT > const& classify = std::use_facet< std::ctype< CharT > >( locale );
+    bool const skip_whitespace = ( stream.flags() & std::ios_base::skipws ) != 0;
+    auto* const buffer = stream.rdbuf();
+
+    // Integers with a fixed radix, in the classic locale, can be scanned here.
+    std::ios_base::fmtflags const basefield = stream.flags() & std::ios_base::basefield;
+    unsigned const base = basefield == std::ios_base::oct ? 8 : basefield == std::ios_base::hex ? 16 : 10;
+    bool const scannable = detail::is_scannable< T >::value && basefield != 0 && locale == std::locale::classic();
+
+    for ( ;; )
+    {
+        std::ios_base::iostate state{ std::ios_base::goodbit };
+        T value{};
+
+        try
+        {
+            if ( !scannable || !detail::scan_value( *buffer, base, state, value, detail::is_scannable< T >{} ) )
+            {
+                detail::get_number( numeric, iterator_type{ buffer }, iterator_type{}, stream, state, value );
+            }
+        }
+        catch ( ... )
+        {
+            detail::absorb_exception( stream );
+            return out;
+        }
+
+        // Report the parse outcome exactly as operator>> would (this may throw).
+        if ( state != std::ios_base::goodbit )
+        {
+            stream.setstate( state );
+        }
+
+        if ( state & std::ios_base::failbit )
+        {
+            return out;
+        }
+
+        *out++ = value;
+
+        if ( state & std::ios_base::eofbit )
+        {
+            // The loop's next extraction would fail at its sentry.
+            stream.setstate( std::ios_base::failbit );
+            return out;
+        }
+
+        // Do the next sentry's work: skip whitespace up to the next value.
+        if ( skip_whitespace )
+        {
+            auto next = Traits::eof();
+
+            try
+            {
+                next = buffer->sgetc();
+
+                while ( !Traits::eq_int_type( next, Traits::eof() )
+                     && classify.is( std::ctype_base::space, Traits::to_char_type( next ) ) )
+                {
+                    next = buffer->snextc();
+                }
+            }
+            catch ( ... )
+            {
+                detail::absorb_exception( stream );
+                return out;
+            }
+
+            if ( Traits::eq_int_type( next, Traits::eof() ) )
+            {
+                stream.setstate( std::ios_base::failbit | std::ios_base::eofbit );
+                return out;
+            }
+        }
+    }
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_READ_RANGE_HPP
@@ -50,6 +50,13 @@ A variety of other, more complex, scenarios can be dealt with
 using the default constructor, capture(), restore(), release(),
 the move-constructor, move-assignment operator and operator bool.
 
+Stream classes which keep their formatting state in a simple struct of
+their own may specialise awo::format_state_traits<> to expose it, and
+are then saved by awo::savefmt_for< Stream >: a separate saver which
+snapshots that block with a plain memcpy() and the stream's basic_ios
+scalars directly, instead of with copyfmt() (see format_state_traits<>
+and state_savefmt<>, below).
+
 Since the introduction of rvalue-references to the C++ language,
 this implementation has adopted their use, thereby circumventing
 the dodgy-looking const-casting that helped facilitate the origin
@@ -68,15 +75,41 @@ formatted extraction/insertion (>>, <<) operators.
 
 #include <ios>          // std::basic_ios<>{}
 #include <string>       // std::char_traits<>{}
+#include <cstring>      // std::memcpy()
+#include <locale>       // std::locale{}
 #include <istream>      // std::basic_istream<>{}
 #include <ostream>      // std::basic_ostream<>{}
 #include <utility>      // std::exchange<>()
+#include <type_traits>  // std::conditional_t<>, std::enable_if_t<>, std::is_base_of<>{}, std::is_trivially_copyable<>{}
 
 //============================================================================
 /// This is the namespace in which all Tony Oliver's distributable components reside.
 namespace awo {
 //----------------------------------------------------------------------------
 
+/// Customisation point through which a stream type can expose its own block of formatting state.
+///
+/// By default (as here) a stream's formatting parameters are those of its \b std::basic_ios
+/// base, which \ref basic_savefmt saves and restores with \b copyfmt().  A stream class that
+/// keeps its formatting state in a trivially-copyable struct of its own may specialise this
+/// template, providing:
+///
+///     static constexpr bool is_specialized = true;
+///     using state_type = /* the trivially-copyable state block */;
+///     static state_type& state( Stream& stream );
+///
+/// Such a stream is then saved by \ref state_savefmt (named for any stream as \ref savefmt_for),
+/// which copies that block and the stream's \b basic_ios scalars (which the standard manipulators
+/// still act upon) without going through \b copyfmt(); \ref basic_savefmt refuses to bind to it.
+///
+/// @tparam Stream - The (most-derived) stream type whose formatting state is described.
+template< typename Stream >
+struct format_state_traits
+{
+    /// Ordinary streams have no state block of their own: use their \b basic_ios parameters.
+    static constexpr bool is_specialized = false;
+};
+
 /// Template from which to create classes that can save/restore stream formatting-parameters.
 ///
 /// When instantiated with an appropriate character type, creates a concrete class definition
@@ -103,6 +136,11 @@ class basic_savefmt
     /// An ios-based object (with no stream buffer) into which the parameters are saved.
     stream_base saved_format{ nullptr };
 
+    /// Selects the overloads refusing streams exposing a \ref format_state_traits block.
+    template< typename Stream >
+    using if_state_block = std::enable_if_t< format_state_traits< Stream >::is_specialized
+                                          && std::is_base_of< stream_base, Stream >::value >;
+
 public:
 
     /// Default constructor: creates an inactive saver/restorer object.
@@ -111,6 +149,10 @@ public:
     /// Capturing constructor: saves parameters from (and a reference to) the given stream.
     explicit basic_savefmt( stream_base& stream );
 
+    /// Streams exposing their own formatting-state block must be saved by \ref savefmt_for instead.
+    template< typename Stream, typename = if_state_block< Stream > >
+    explicit basic_savefmt( Stream& stream ) = delete;
+
     /// Objects of this type \a can be move-constructed in the normal manner.
     basic_savefmt( basic_savefmt&& other );
 
@@ -130,6 +172,10 @@ public:
     /// Save a stream's formatting parameters (possibly restoring any that are already captured).
     void capture( stream_base& stream );
 
+    /// Streams exposing their own formatting-state block must be saved by \ref savefmt_for instead.
+    template< typename Stream, typename = if_state_block< Stream > >
+    void capture( Stream& stream ) = delete;
+
     /// Restore saved parameters back to the stream from which they came.
     void restore();
 
@@ -142,6 +188,113 @@ public:
     stream_base* stream() const;
 };
 
+/// Template from which to create savers for streams exposing a \ref format_state_traits block.
+///
+/// Saves the stream's own formatting-state block (with \b memcpy()) together with the
+/// \b basic_ios scalars the standard manipulators act upon - flags, width, precision,
+/// fill, tie, exception mask and locale - each read and written directly, rather than
+/// through \b copyfmt() as \ref basic_savefmt does.  The locale is re-imbued, and the
+/// exception mask re-applied, only if they have changed.  The stream's \b iword() and
+/// \b pword() arrays and callbacks are neither saved nor restored.
+///
+/// It offers the same interface as \ref basic_savefmt; name it generically as
+/// \ref savefmt_for, which selects whichever saver suits a given stream type.
+///
+/// @tparam Stream - The (most-derived) stream type, for which \ref format_state_traits is specialised.
+template< typename Stream >
+class state_savefmt
+{
+    /// How the stream exposes its formatting-state block.
+    using state_traits = format_state_traits< Stream >;
+
+    /// The stream's formatting-state block.
+    using state_type = typename state_traits::state_type;
+
+    static_assert( std::is_trivially_copyable< state_type >::value,
+                   "format_state_traits<>::state_type must be trivially copyable" );
+
+    /// The stream type to which the saved tie refers.
+    using tie_type = std::basic_ostream< typename Stream::char_type, typename Stream::traits_type >;
+
+    /// A record of which stream's formatting parameters we are holding; initially none.
+    Stream* bound_stream{ nullptr };
+
+    /// The stream's locale (a copy of the classic locale while inactive, which costs no lock).
+    std::locale saved_locale{ std::locale::classic() };
+
+    /// The stream's tied output stream.
+    tie_type* saved_tie{ nullptr };
+
+    /// The stream's field width.
+    std::streamsize saved_width{ 0 };
+
+    /// The stream's floating-point precision.
+    std::streamsize saved_precision{ 0 };
+
+    /// The stream's format flags.
+    std::ios_base::fmtflags saved_flags{};
+
+    /// The stream's exception mask.
+    std::ios_base::iostate saved_exceptions{};
+
+    /// The stream's fill character.
+    typename Stream::char_type saved_fill{};
+
+    /// A copy of the stream's own formatting-state block.
+    state_type saved_state;
+
+    /// Bind to the given stream and snapshot its parameters and state block.
+    void snapshot( Stream& stream );
+
+    /// Adopt the parameters (and stream) held by another instance, unbinding it.
+    void take( state_savefmt& other );
+
+public:
+
+    /// Default constructor: creates an inactive saver/restorer object.
+    state_savefmt() = default;
+
+    /// Capturing constructor: saves parameters from (and a reference to) the given stream.
+    explicit state_savefmt( Stream& stream );
+
+    /// Objects of this type \a can be move-constructed in the normal manner.
+    state_savefmt( state_savefmt&& other );
+
+    /// Objects of this type \a cannot be copy-constructed.
+    state_savefmt( state_savefmt const& ) = delete;
+
+    /// If we have a stream's formatting parameters captured, the destructor restores them.
+    ~state_savefmt();
+
+    /// Objects of this type \a can be move-assigned in the normal manner.
+    /// @return \b *this as a \b state_savefmt&
+    state_savefmt& operator=( state_savefmt&& other );
+
+    /// Objects of this type \a cannot be copy-assigned.
+    state_savefmt& operator=( state_savefmt const& ) = delete;
+
+    /// Save a stream's formatting parameters (possibly restoring any that are already captured).
+    void capture( Stream& stream );
+
+    /// Restore saved parameters back to the stream from which they came.
+    void restore();
+
+    /// Reset this object such that it no longer holds a stream's parameters.
+    void release();
+
+    /// Reports the associated stream (whose formatting parameters have been saved).
+    /// \return a pointer to the stream (if this object is "active");
+    /// \return a null pointer if not.
+    Stream* stream() const;
+};
+
+/// The saver suited to a stream type: \ref state_savefmt for streams exposing a
+/// \ref format_state_traits block, otherwise \ref basic_savefmt over the stream's character type.
+template< typename Stream >
+using savefmt_for = std::conditional_t< format_state_traits< Stream >::is_specialized,
+                                        state_savefmt< Stream >,
+                                        basic_savefmt< typename Stream::char_type, typename Stream::traits_type > >;
+
 /*------------------------------------------*\
 |*  Stream extraction/insertion operators:  *|
 \*------------------------------------------*/
@@ -158,6 +311,28 @@ std::basic_ostream< CharT, Traits >&
 operator<<( std::basic_ostream<CharT, Traits>& stream,
                  basic_savefmt<CharT, Traits>&& saver );
 
+/// Streams exposing a \ref format_state_traits block must be saved by \ref savefmt_for instead.
+template< typename Stream, typename = std::enable_if_t< format_state_traits< Stream >::is_specialized > >
+Stream&
+operator>>( Stream& stream,
+            basic_savefmt<typename Stream::char_type, typename Stream::traits_type>&& saver ) = delete;
+
+/// Streams exposing a \ref format_state_traits block must be saved by \ref savefmt_for instead.
+template< typename Stream, typename = std::enable_if_t< format_state_traits< Stream >::is_specialized > >
+Stream&
+operator<<( Stream& stream,
+            basic_savefmt<typename Stream::char_type, typename Stream::traits_type>&& saver ) = delete;
+
+/// Stream extraction-operator to handle state_savefmt instances appearing in \b operator>> chains.
+template< typename Stream, typename = std::enable_if_t< format_state_traits< Stream >::is_specialized > >
+Stream&
+operator>>( Stream& stream, state_savefmt< Stream >&& saver );
+
+/// Stream insertion-operator to handle state_savefmt instances appearing in \b operator<< chains.
+template< typename Stream, typename = std::enable_if_t< format_state_traits< Stream >::is_specialized > >
+Stream&
+operator<<( Stream& stream, state_savefmt< Stream >&& saver );
+
 /*------------------------------------------------------*\
 |*  Specialisations for common stream character-types:  *|
 \*------------------------------------------------------*/
@@ -324,4 +499,191 @@ awo::operator<<( std::basic_ostream< CharT, Traits >& stream,
 
 //============================================================================
 
+template< typename Stream >
+awo::state_savefmt< Stream >::
+state_savefmt( Stream& stream )
+: bound_stream{ &stream }
+, saved_locale{ stream.getloc() }
+{
+    // We've now bound this instance to the given stream and copied its locale (above).
+
+    // Capture the rest of its formatting parameters for later restoration.
+    snapshot( stream );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+awo::state_savefmt< Stream >::
+state_savefmt( state_savefmt&& other )
+{
+    // Bind to the other instance's stream and unbind that other from it.
+    take( other );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+auto
+awo::state_savefmt< Stream >::
+operator=( state_savefmt&& other )
+-> state_savefmt&
+{
+    if ( &other != this )
+    {
+        // Bind to the other instance's stream and unbind that other from it.
+        take( other );
+    }
+
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+void
+awo::state_savefmt< Stream >::
+take( state_savefmt& other )
+{
+    bound_stream     = std::exchange( other.bound_stream, nullptr );
+    saved_locale     = std::move( other.saved_locale );
+    saved_tie        = other.saved_tie;
+    saved_width      = other.saved_width;
+    saved_precision  = other.saved_precision;
+    saved_flags      = other.saved_flags;
+    saved_exceptions = other.saved_exceptions;
+    saved_fill       = other.saved_fill;
+
+    std::memcpy( &saved_state, &other.saved_state, sizeof( state_type ) );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+void
+awo::state_savefmt< Stream >::
+capture( Stream& stream )
+{
+    // If we are currently active, restore the saved parameters to the stream.
+    restore();
+
+    // Now bind to the new stream.
+    bound_stream = &stream;
+    saved_locale = stream.getloc();
+
+    // And capture the rest of its formatting parameters for later restoration.
+    snapshot( stream );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+void
+awo::state_savefmt< Stream >::
+snapshot( Stream& stream )
+{
+    saved_tie        = stream.tie();
+    saved_width      = stream.width();
+    saved_precision  = stream.precision();
+    saved_flags      = stream.flags();
+    saved_exceptions = stream.exceptions();
+    saved_fill       = stream.fill();
+
+    std::memcpy( &saved_state, &state_traits::state( stream ), sizeof( state_type ) );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+void
+awo::state_savefmt< Stream >::
+restore()
+{
+    // Inactive instances ignore this request
+    if ( bound_stream == nullptr )
+    {
+        return;
+    }
+
+    // The stream's own block and its scalar parameters cannot fail to be restored...
+    std::memcpy( &state_traits::state( *bound_stream ), &saved_state, sizeof( state_type ) );
+
+    bound_stream->flags( saved_flags );
+    bound_stream->width( saved_width );
+    bound_stream->precision( saved_precision );
+    bound_stream->fill( saved_fill );
+    bound_stream->tie( saved_tie );
+
+    // ...whereas re-imbuing the locale (which notifies the stream's callbacks) is only
+    // worth doing if it has actually changed.
+    if ( bound_stream->getloc() != saved_locale )
+    {
+        bound_stream->imbue( saved_locale );
+    }
+
+    // Last, as (like copyfmt()) this may throw if the stream's state is already bad.
+    if ( bound_stream->exceptions() != saved_exceptions )
+    {
+        bound_stream->exceptions( saved_exceptions );
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+void
+awo::state_savefmt< Stream >::
+release()
+{
+    // Unbind from the stream, so the saved parameters will not be restored.
+    bound_stream = nullptr;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+Stream*
+awo::state_savefmt< Stream >::
+stream() const
+{
+    // Return a pointer to the stream to which we are bound (or nullptr).
+    return bound_stream;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream >
+awo::state_savefmt< Stream >::
+~state_savefmt()
+{
+    // Restore any saved formatting parameters to their stream (if any).
+    restore();
+}
+
+//============================================================================
+
+template< typename Stream, typename >
+Stream&
+awo::operator>>( Stream& stream, awo::state_savefmt< Stream >&& saver )
+{
+    // As for basic_savefmt: the saver expires, restoring the stream, at the end of the expression.
+    saver.capture( stream );
+
+    return stream;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename Stream, typename >
+Stream&
+awo::operator<<( Stream& stream, awo::state_savefmt< Stream >&& saver )
+{
+    // As for basic_savefmt: the saver expires, restoring the stream, at the end of the expression.
+    saver.capture( stream );
+
+    return stream;
+}
+
+//============================================================================
+
 #endif // INCLUDED_AWO_SAVEFMT_HPP
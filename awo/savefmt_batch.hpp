@@ -0,0 +1,529 @@
+#ifndef INCLUDED_AWO_SAVEFMT_BATCH_HPP
+#define INCLUDED_AWO_SAVEFMT_BATCH_HPP
+
+/*
+Header file "awo/savefmt_batch.hpp"
+
+Copyright (c) 2005-2023:, Tony Oliver (H D Computer Services Ltd.)
+
+Permission to use, copy, modify, distribute and sell this software
+and its documentation for any purpose is hereby granted without fee,
+provided that the above copyright notice appears in all copies and
+that both that copyright notice and this permission notice appear
+in supporting documentation. H D Computer Services Ltd. makes no
+representations about the suitability of this software for any
+purpose. It is provided "as is" without express or implied warranty.
+
+------------------------------------------------------------------------------
+
+This class template saves the formatting parameters of many streams
+at once and, later, restores only those streams whose parameters have
+actually been changed in the meantime.
+
+Where a basic_savefmt holds a complete (basic_ios) copy of one stream's
+format, and always restores it with copyfmt(), a basic_savefmt_batch
+keeps a compact snapshot of each stream - its flags, width, precision,
+fill character, locale, tied stream and exception mask - held field by
+field in parallel arrays.  On restore(), every stream is compared with
+its snapshot in a single pass of scalar comparisons (combined without
+branching, and touching no shared reference-counts), building a bitmap of those that differ; only those are then written
+back, field by field.
+
+Locales are not compared in that pass (copying a std::locale costs two
+atomic reference-count updates).  Instead, capture() registers a
+callback on each stream which, whenever the stream is imbued or has
+another's format copied to it, stamps a process-unique "epoch" into an
+iword() of the stream; the pass compares that epoch with the one
+captured.  A different epoch means only that the locale may have been
+replaced - every basic_savefmt capture and restore is a copyfmt(), and
+stamps one - so for those streams alone the locales are compared: if
+they match, the new epoch is simply adopted by the snapshot.
+
+A stream may be captured more than once (as nested savers might be):
+each stream captured is marked, in two more iword()s, with the batch
+and the index of its first snapshot, so that capturing it again takes
+no further snapshot but returns that first one - and restore(), done
+as often as one likes, always leaves the stream as it was first found.
+(Should another batch capture the stream in between, or a stream no
+batch holds have its format copied to it, those marks are overwritten:
+a further capture then takes a new snapshot, which supersedes the
+earlier one as the one restored.)
+
+A simple example:
+
+void serve( std::vector< client >& clients )
+{
+    awo::savefmt_batch saver;
+    for ( auto& c : clients ) saver.capture( c.stream );
+
+    for ( auto& c : clients ) c.handle_requests(); // may change formats
+
+    // (destructor of saver restores only those streams that were changed)
+}
+
+The stream's iword()/pword() storage and registered callbacks are not
+part of the snapshot (nor, therefore, restored): a stream whose users
+depend on those should be guarded by a basic_savefmt instead.  (The
+epoch callback, and its iword() slot, stay with a stream once captured.)  Where a
+stream's locale must be restored, that is done by imbue() - so its
+stream buffer is also re-imbued and imbue_event callbacks are made.
+*/
+
+/// @file awo/savefmt_batch.hpp
+/// @author Tony Oliver <tony@oliver.net>
+
+#if __cplusplus <= 201411L
+#error Header file "awo/savefmt_batch.hpp" requires at least C++14 capabilities.
+#endif
+
+#include <ios>          // std::basic_ios<>{}, std::ios_base{}, std::streamsize
+#include <locale>       // std::locale{}
+#include <string>       // std::char_traits<>{}
+#include <vector>       // std::vector<>{}
+#include <cstddef>      // std::size_t
+#include <atomic>       // std::atomic<>{}
+#include <cstdint>      // std::uint64_t
+#include <ostream>      // std::basic_ostream<>{}
+
+//============================================================================
+/// This is the namespace in which all Tony Oliver's distributable components reside.
+namespace awo {
+//----------------------------------------------------------------------------
+
+/// Template from which to create classes that save/restore many streams' formatting-parameters.
+///
+/// @tparam CharT - The character type on which to instantiate this template.
+/// @tparam Traits - The character-traits type on which to instantiate this template
+/// (usually omitted and the char_traits<> default used).
+///
+/// See also the pre-instantiated typedefs \ref savefmt_batch and \ref wsavefmt_batch.
+
+template< typename CharT, typename Traits = std::char_traits< CharT > >
+class basic_savefmt_batch
+{
+    /// The relevant base class of all streams of which we can save formatting parameters.
+    using stream_base = std::basic_ios< CharT, Traits >;
+
+    /// The type of stream to which a stream can be tied.
+    using tied_stream = std::basic_ostream< CharT, Traits >;
+
+    /// The streams whose formatting parameters we are holding, one per snapshot.
+    std::vector< stream_base* > streams;
+
+    /// The snapshots themselves, one field per array (all indexed alike).
+    std::vector< std::ios_base::fmtflags > saved_flags;
+    std::vector< std::streamsize > saved_widths;
+    std::vector< std::streamsize > saved_precisions;
+    std::vector< CharT > saved_fills;
+    std::vector< std::locale > saved_locales;
+    std::vector< tied_stream* > saved_ties;
+    std::vector< std::ios_base::iostate > saved_exceptions;
+    std::vector< long > saved_epochs;
+
+    /// One bit per snapshot, set where the stream no longer matches it.
+    std::vector< std::uint64_t > dirty;
+
+    /// This batch's mark, as left on the streams it captures.
+    long batch_id{ next_epoch() };
+
+    /// The index of the iword() in which each captured stream holds its epoch.
+    static int epoch_slot();
+
+    /// The index of the iword() in which each captured stream holds the id of the batch that last captured it.
+    static int owner_slot();
+
+    /// The index of the iword() in which each captured stream holds its first snapshot's index in that batch.
+    static int index_slot();
+
+    /// Mark the stream as captured by this batch, in the given snapshot.
+    void mark_owned( stream_base& stream, std::size_t index );
+
+    /// Reports whether the given snapshot has been superseded by another of the same stream.
+    bool superseded( stream_base& stream, std::size_t index ) const;
+
+    /// A new, process-unique (and non-zero) epoch (also used for batch ids).
+    static long next_epoch();
+
+    /// Stamp a new epoch into a stream whose locale (or whole format) has been replaced.
+    static void on_event( std::ios_base::event event, std::ios_base& stream, int index );
+
+    /// Compare every stream with its snapshot, (re)building the \ref dirty bitmap.
+    /// @return the number of streams found to have changed.
+    std::size_t mark_dirty();
+
+    /// Write the given snapshot back to its stream.
+    void write_back( std::size_t index );
+
+public:
+
+    /// Default constructor: creates an empty batch.
+    basic_savefmt_batch() = default;
+
+    /// Objects of this type \a can be move-constructed in the normal manner.
+    basic_savefmt_batch( basic_savefmt_batch&& other ) = default;
+
+    /// Objects of this type \a cannot be copy-constructed.
+    basic_savefmt_batch( basic_savefmt_batch const& ) = delete;
+
+    /// The destructor restores any streams whose parameters have changed.
+    ~basic_savefmt_batch();
+
+    /// Objects of this type \a cannot be move-assigned (as the saved parameters would be lost).
+    basic_savefmt_batch& operator=( basic_savefmt_batch&& ) = delete;
+
+    /// Objects of this type \a cannot be copy-assigned.
+    basic_savefmt_batch& operator=( basic_savefmt_batch const& ) = delete;
+
+    /// Make room for the given number of snapshots without reallocation.
+    void reserve( std::size_t count );
+
+    /// Save a further stream's formatting parameters (unless already held).
+    /// @return the index of the stream's snapshot (its first, if it was already held).
+    std::size_t capture( stream_base& stream );
+
+    /// Restore saved parameters to those streams whose parameters have since changed.
+    /// @return the number of streams restored.
+    std::size_t restore();
+
+    /// Forget all snapshots, so that none will be restored.
+    void release();
+
+    /// Reports the number of snapshots held (normally one per stream captured).
+    std::size_t size() const;
+
+    /// Reports the stream from which the given snapshot was taken.
+    stream_base* stream( std::size_t index ) const;
+};
+
+/*------------------------------------------------------*\
+|*  Specialisations for common stream character-types:  *|
+\*------------------------------------------------------*/
+
+/// Pre-declared instantiation and typedef of template \b basic_savefmt_batch over the character-type \b char.
+using  savefmt_batch = basic_savefmt_batch< char >;
+
+/// Pre-declared instantiation and typedef of template \b basic_savefmt_batch over the character-type \b wchar_t.
+using wsavefmt_batch = basic_savefmt_batch< wchar_t >;
+
+//----------------------------------------------------------------------------
+} // close namespace awo
+//============================================================================
+
+/*==============================================*\
+|*                                              *|
+|*  I M P L E M E N T A T I O N   D E T A I L   *|
+|*                                              *|
+\*==============================================*/
+
+template< typename CharT, typename Traits >
+void
+awo::basic_savefmt_batch< CharT, Traits >::
+reserve( std::size_t const count )
+{
+    streams.reserve( count );
+    saved_flags.reserve( count );
+    saved_widths.reserve( count );
+    saved_precisions.reserve( count );
+    saved_fills.reserve( count );
+    saved_locales.reserve( count );
+    saved_ties.reserve( count );
+    saved_exceptions.reserve( count );
+    saved_epochs.reserve( count );
+    dirty.reserve( ( count + 63 ) / 64 );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+int
+awo::basic_savefmt_batch< CharT, Traits >::
+epoch_slot()
+{
+    static int const slot = std::ios_base::xalloc();
+    return slot;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+int
+awo::basic_savefmt_batch< CharT, Traits >::
+owner_slot()
+{
+    static int const slot = std::ios_base::xalloc();
+    return slot;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+int
+awo::basic_savefmt_batch< CharT, Traits >::
+index_slot()
+{
+    static int const slot = std::ios_base::xalloc();
+    return slot;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_savefmt_batch< CharT, Traits >::
+mark_owned( stream_base& stream, std::size_t const index )
+{
+    stream.iword( owner_slot() ) = batch_id;
+    stream.iword( index_slot() ) = static_cast< long >( index );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+bool
+awo::basic_savefmt_batch< CharT, Traits >::
+superseded( stream_base& stream, std::size_t const index ) const
+{
+    // Marks copied (by copyfmt()) from another of our streams name a snapshot of that other stream.
+    if ( stream.iword( owner_slot() ) != batch_id )
+    {
+        return false;
+    }
+
+    std::size_t const first = static_cast< std::size_t >( stream.iword( index_slot() ) );
+    return first != index && first < streams.size() && streams[ first ] == &stream;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+long
+awo::basic_savefmt_batch< CharT, Traits >::
+next_epoch()
+{
+    static std::atomic< long > last{ 0 };
+    return ++last;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_savefmt_batch< CharT, Traits >::
+on_event( std::ios_base::event const event, std::ios_base& stream, int )
+{
+    // (copyfmt() replaces the locale without an imbue_event; it copies this callback with the epoch.)
+    if ( event == std::ios_base::imbue_event || event == std::ios_base::copyfmt_event )
+    {
+        stream.iword( epoch_slot() ) = next_epoch();
+    }
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_savefmt_batch< CharT, Traits >::
+capture( stream_base& stream )
+{
+    // A stream we already hold keeps its first snapshot.
+    if ( stream.iword( owner_slot() ) == batch_id )
+    {
+        std::size_t const first = static_cast< std::size_t >( stream.iword( index_slot() ) );
+
+        if ( first < streams.size() && streams[ first ] == &stream )
+        {
+            return first;
+        }
+    }
+
+    long& epoch = stream.iword( epoch_slot() );
+
+    // A zero epoch is never stamped: it marks a stream without our callback.
+    if ( epoch == 0 )
+    {
+        stream.register_callback( &on_event, 0 );
+        epoch = next_epoch();
+    }
+
+    streams.push_back( &stream );
+    saved_flags.push_back( stream.flags() );
+    saved_widths.push_back( stream.width() );
+    saved_precisions.push_back( stream.precision() );
+    saved_fills.push_back( stream.fill() );
+    saved_locales.push_back( stream.getloc() );
+    saved_ties.push_back( stream.tie() );
+    saved_exceptions.push_back( stream.exceptions() );
+    saved_epochs.push_back( stream.iword( epoch_slot() ) );
+
+    std::size_t const index = streams.size() - 1;
+    mark_owned( stream, index );
+
+    return index;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_savefmt_batch< CharT, Traits >::
+mark_dirty()
+{
+    std::size_t const count = streams.size();
+    std::size_t changed = 0;
+    int const slot = epoch_slot();
+
+    dirty.assign( ( count + 63 ) / 64, 0 );
+
+    for ( std::size_t index = 0; index < count; ++index )
+    {
+        stream_base& live = *streams[ index ];
+
+        // Bitwise (not logical) or-ing: every field is compared, without branching.
+        bool differs = ( live.flags()      != saved_flags[ index ] )
+                     | ( live.width()      != saved_widths[ index ] )
+                     | ( live.precision()  != saved_precisions[ index ] )
+                     | !Traits::eq( live.fill(), saved_fills[ index ] )
+                     | ( live.tie()        != saved_ties[ index ] )
+                     | ( live.exceptions() != saved_exceptions[ index ] );
+
+        // A new epoch means the locale may have changed: only then is it compared (and, if
+        // unchanged, the epoch adopted).  A zero epoch means our callback was copied away.
+        long const epoch = live.iword( slot );
+
+        if ( epoch != saved_epochs[ index ] )
+        {
+            if ( epoch != 0 && live.getloc() == saved_locales[ index ] )
+            {
+                saved_epochs[ index ] = epoch;
+            }
+            else
+            {
+                differs = true;
+            }
+        }
+
+        // (Rare) a later snapshot, taken after the stream's marks were overwritten, is restored instead.
+        differs = differs && !superseded( live, index );
+
+        dirty[ index / 64 ] |= std::uint64_t{ differs } << ( index % 64 );
+        changed += differs;
+    }
+
+    return changed;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_savefmt_batch< CharT, Traits >::
+write_back( std::size_t const index )
+{
+    stream_base& live = *streams[ index ];
+
+    live.flags( saved_flags[ index ] );
+    live.width( saved_widths[ index ] );
+    live.precision( saved_precisions[ index ] );
+    live.fill( saved_fills[ index ] );
+    live.tie( saved_ties[ index ] );
+
+    if ( live.getloc() != saved_locales[ index ] )
+    {
+        live.imbue( saved_locales[ index ] );
+    }
+
+    // A copyfmt() from a stream without our callback will have removed it (and our marks) from this one.
+    if ( live.iword( epoch_slot() ) == 0 )
+    {
+        live.register_callback( &on_event, 0 );
+    }
+
+    mark_owned( live, index );
+
+    // After imbue() (which stamps a new epoch), so that the stream matches its snapshot again.
+    live.iword( epoch_slot() ) = saved_epochs[ index ];
+
+    // Last, as copyfmt() does: this may throw if the stream's state is now of interest.
+    live.exceptions( saved_exceptions[ index ] );
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_savefmt_batch< CharT, Traits >::
+restore()
+{
+    std::size_t const changed = mark_dirty();
+
+    // Visit only the set bits of the bitmap (last first, as for a stack of savers).
+    for ( std::size_t word = dirty.size(); word-- > 0; )
+    {
+        for ( std::uint64_t bits = dirty[ word ]; bits != 0; )
+        {
+#if defined( __GNUC__ )
+            std::size_t const bit = 63 - __builtin_clzll( bits );
+#else
+            std::size_t bit = 63;
+            while ( ( bits >> bit & 1 ) == 0 ) --bit;
+#endif
+            bits &= ~( std::uint64_t{ 1 } << bit );
+            write_back( word * 64 + bit );
+        }
+    }
+
+    return changed;
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+void
+awo::basic_savefmt_batch< CharT, Traits >::
+release()
+{
+    streams.clear();
+    saved_flags.clear();
+    saved_widths.clear();
+    saved_precisions.clear();
+    saved_fills.clear();
+    saved_locales.clear();
+    saved_ties.clear();
+    saved_exceptions.clear();
+    saved_epochs.clear();
+    dirty.clear();
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+std::size_t
+awo::basic_savefmt_batch< CharT, Traits >::
+size() const
+{
+    return streams.size();
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+auto
+awo::basic_savefmt_batch< CharT, Traits >::
+stream( std::size_t const index ) const -> stream_base*
+{
+    return streams[ index ];
+}
+
+//----------------------------------------------------------------------------
+
+template< typename CharT, typename Traits >
+awo::basic_savefmt_batch< CharT, Traits >::
+~basic_savefmt_batch()
+{
+    // Restore any streams whose formatting parameters have changed.
+    restore();
+}
+
+//============================================================================
+
+#endif // INCLUDED_AWO_SAVEFMT_BATCH_HPP
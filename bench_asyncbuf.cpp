@@ -0,0 +1,168 @@
+#include "awo/savefmt.hpp"  // awo::savefmt{}
+#include "awo/asyncbuf.hpp" // awo::asyncbuf{}
+#include "bench_latency.hpp" // bench::latency_histogram{}, bench::time_ns<>()
+
+#include <string>           // std::string{}
+#include <vector>           // std::vector<>{}
+#include <cstdio>           // std::remove()
+#include <cstdlib>          // std::strtoul()
+#include <cstring>          // std::strcmp()
+#include <fstream>          // std::filebuf{}, std::ifstream{}
+#include <iomanip>          // std::setfill(), std::setw()
+#include <ostream>          // std::ostream{}
+#include <iterator>         // std::istreambuf_iterator<>{}
+#include <iostream>         // std::cout, std::cerr
+#include <stdexcept>        // std::invalid_argument{}, std::runtime_error{}
+
+#include <fcntl.h>          // ::open(), O_*
+#include <unistd.h>         // ::close()
+
+// Measures the latency, as seen by the formatting ("hot") thread, of each
+// line of a report - including the flush that ends every n-th line - when
+// written through a std::filebuf and through an awo::asyncbuf, writing
+// the two latency distributions as JSON: once flushing every line (as
+// std::endl does) and once flushing every n-th line.
+//
+// usage: bench_asyncbuf [--lines N] [--flush-every N] [--directory DIR]
+
+namespace { // unnamed
+
+void write_line( std::ostream& out, unsigned long const line, bool const flush )
+{
+    out << "record " << line << ": "
+        << awo::savefmt{} << std::hex << std::uppercase << std::setfill( '0' )
+        << "0x" << std::setw( 16 ) << line * 2654435761ul
+        << '\n';
+
+    if ( flush )
+    {
+        out.flush();
+    }
+}
+
+void write_report( std::ostream& out, bench::latency_histogram& latencies,
+                   unsigned long const lines, unsigned long const flush_every )
+{
+    for ( unsigned long line = 0; line < lines; ++line )
+    {
+        bool const flush = ( line + 1 ) % flush_every == 0;
+        latencies.record( bench::time_ns( [ & ] { write_line( out, line, flush ); } ) );
+    }
+}
+
+bench::latency_histogram time_filebuf( std::string const& path, unsigned long const lines, unsigned long const flush_every )
+{
+    bench::latency_histogram latencies;
+    std::filebuf buffer;
+
+    if ( buffer.open( path, std::ios_base::out | std::ios_base::trunc ) == nullptr )
+    {
+        throw std::runtime_error{ "cannot open " + path };
+    }
+
+    std::ostream out{ &buffer };
+    write_report( out, latencies, lines, flush_every );
+
+    return latencies;
+}
+
+bench::latency_histogram time_asyncbuf( std::string const& path, unsigned long const lines, unsigned long const flush_every )
+{
+    bench::latency_histogram latencies;
+    int const fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+
+    if ( fd < 0 )
+    {
+        throw std::runtime_error{ "cannot open " + path };
+    }
+
+    {
+        awo::asyncbuf buffer{ fd };
+        std::ostream out{ &buffer };
+        write_report( out, latencies, lines, flush_every );
+    }
+
+    ::close( fd );
+
+    return latencies;
+}
+
+std::string contents_of( std::string const& path )
+{
+    std::ifstream in{ path, std::ios_base::binary };
+    return { std::istreambuf_iterator< char >{ in }, std::istreambuf_iterator< char >{} };
+}
+
+/// Time both buffers, flushing every n-th line, and write the results as one JSON object.
+/// @return whether the two files written were identical.
+bool compare( std::string const& directory, unsigned long const lines, unsigned long const flush_every, bool const last )
+{
+    std::string const filebuf_path  = directory + "/bench_asyncbuf.filebuf";
+    std::string const asyncbuf_path = directory + "/bench_asyncbuf.asyncbuf";
+
+    bench::latency_histogram const filebuf_latencies  = time_filebuf( filebuf_path, lines, flush_every );
+    bench::latency_histogram const asyncbuf_latencies = time_asyncbuf( asyncbuf_path, lines, flush_every );
+    bool const identical = contents_of( filebuf_path ) == contents_of( asyncbuf_path );
+
+    std::remove( filebuf_path.c_str() );
+    std::remove( asyncbuf_path.c_str() );
+
+    std::cout << "    {\n";
+    std::cout << "      \"flush_every\": " << flush_every << ",\n";
+    std::cout << "      \"identical_output\": " << ( identical ? "true" : "false" ) << ",\n";
+    std::cout << "      \"filebuf\": ";  filebuf_latencies.write_json( std::cout );  std::cout << ",\n";
+    std::cout << "      \"asyncbuf\": "; asyncbuf_latencies.write_json( std::cout ); std::cout << "\n";
+    std::cout << "    }" << ( last ? "\n" : ",\n" );
+
+    return identical;
+}
+
+} // close unnamed namespace
+
+int main( int const argc, char const* const argv[] )
+{
+    try
+    {
+        unsigned long lines = 2000000;
+        unsigned long flush_every = 100;
+        std::string directory = "/tmp";
+
+        for ( int arg = 1; arg + 1 < argc; arg += 2 )
+        {
+            if      ( std::strcmp( argv[ arg ], "--lines" ) == 0 )       lines = std::strtoul( argv[ arg + 1 ], nullptr, 0 );
+            else if ( std::strcmp( argv[ arg ], "--flush-every" ) == 0 ) flush_every = std::strtoul( argv[ arg + 1 ], nullptr, 0 );
+            else if ( std::strcmp( argv[ arg ], "--directory" ) == 0 )   directory = argv[ arg + 1 ];
+            else throw std::invalid_argument{ std::string{ "unknown option " } + argv[ arg ] };
+        }
+
+        if ( flush_every == 0 )
+        {
+            throw std::invalid_argument{ "--flush-every must be at least 1" };
+        }
+
+        // Every line (as with std::endl), and then the interval requested (if different).
+        std::vector< unsigned long > intervals{ 1 };
+        if ( flush_every != 1 ) intervals.push_back( flush_every );
+
+        std::cout << "{\n";
+        std::cout << "  \"benchmark\": \"asyncbuf_latency\",\n";
+        std::cout << "  \"lines\": " << lines << ",\n";
+        std::cout << "  \"results\": [\n";
+
+        bool identical = true;
+        for ( std::size_t i = 0; i < intervals.size(); ++i )
+        {
+            identical = compare( directory, lines, intervals[ i ], i + 1 == intervals.size() ) && identical;
+        }
+
+        std::cout << "  ]\n";
+        std::cout << "}" << std::endl;
+
+        return identical ? 0 : 1;
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
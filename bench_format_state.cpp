@@ -0,0 +1,132 @@
+#include "awo/savefmt.hpp"  // awo::savefmt{}, awo::savefmt_for<>{}, awo::format_state_traits<>{}
+
+#include <chrono>           // std::chrono::steady_clock{}
+#include <cstdlib>          // std::strtoul()
+#include <sstream>          // std::ostringstream{}
+#include <iostream>         // std::cout, std::cerr
+
+// Compares saving and restoring a stream that exposes its own formatting-
+// state block (through awo::format_state_traits<>) with awo::savefmt_for<>,
+// which copies that block and the basic_ios scalars directly, against
+// doing the same with copyfmt() - that is, awo::savefmt bound to the
+// stream's basic_ios, plus a copy of the block by hand.  Each save is
+// followed by a change to the stream's format and then by a restore.
+//
+// usage: bench_format_state [saves]
+
+namespace { // unnamed
+
+using clock_type = std::chrono::steady_clock;
+
+/// An output stream carrying a small formatting-state block of its own.
+class report_stream : public std::ostream
+{
+public:
+
+    struct layout
+    {
+        int  indent;
+        char bullet;
+        bool verbose;
+    };
+
+    layout state{ 0, '-', false };
+
+    explicit report_stream( std::streambuf* const buffer ) : std::ostream{ buffer } {}
+};
+
+} // close unnamed namespace
+
+namespace awo {
+
+template<>
+struct format_state_traits< report_stream >
+{
+    static constexpr bool is_specialized = true;
+    using state_type = report_stream::layout;
+    static state_type& state( report_stream& stream ) { return stream.state; }
+};
+
+} // close namespace awo
+
+namespace { // unnamed
+
+/// Change both the stream's own block and its basic_ios parameters, as a report would.
+void reformat( report_stream& report, unsigned long const i )
+{
+    report.state.indent = static_cast< int >( i & 7 );
+    report.flags( std::ios_base::hex | std::ios_base::uppercase );
+    report.width( 8 );
+    report.fill( '0' );
+}
+
+double time_copyfmt( report_stream& report, unsigned long const saves )
+{
+    auto const start = clock_type::now();
+
+    for ( unsigned long i = 0; i < saves; ++i )
+    {
+        awo::savefmt const saver{ static_cast< std::ostream& >( report ) };
+        report_stream::layout const block = report.state;
+
+        reformat( report, i );
+
+        report.state = block;
+    }
+
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+double time_savefmt_for( report_stream& report, unsigned long const saves )
+{
+    auto const start = clock_type::now();
+
+    for ( unsigned long i = 0; i < saves; ++i )
+    {
+        awo::savefmt_for< report_stream > const saver{ report };
+
+        reformat( report, i );
+    }
+
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+bool pristine( report_stream const& report )
+{
+    std::ostringstream const fresh;
+
+    return report.state.indent == 0 && report.flags() == fresh.flags()
+        && report.width() == 0 && report.fill() == ' ';
+}
+
+} // close unnamed namespace
+
+int main( int const argc, char const* const argv[] )
+{
+    try
+    {
+        unsigned long const saves = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 0 ) : 2000000ul;
+
+        std::ostringstream sink;
+        report_stream report{ sink.rdbuf() };
+
+        double const copyfmt_seconds = time_copyfmt( report, saves );
+        bool restored = pristine( report );
+
+        double const traits_seconds = time_savefmt_for( report, saves );
+        restored = pristine( report ) && restored;
+
+        std::cout << "saves:        " << saves << std::endl;
+        std::cout << "copyfmt:      " << copyfmt_seconds << " s" << std::endl;
+        std::cout << "savefmt_for:  " << traits_seconds << " s" << std::endl;
+        std::cout << "speed-up:     " << copyfmt_seconds / traits_seconds << std::endl;
+        std::cout << "restored:     " << ( restored ? "yes" : "NO" ) << std::endl;
+
+        return restored ? 0 : 1;
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
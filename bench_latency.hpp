@@ -0,0 +1,97 @@
+#ifndef INCLUDED_BENCH_LATENCY_HPP
+#define INCLUDED_BENCH_LATENCY_HPP
+
+// Per-operation latency recording shared by the benchmark programs.
+//
+// Each sample is binned into a log-linear histogram (64 sub-buckets per
+// power of two, i.e. better than 2% resolution), so recording is cheap
+// and allocation-free and percentiles can be read off afterwards.
+
+#include <array>            // std::array<>{}
+#include <chrono>           // std::chrono::steady_clock{}
+#include <cstdint>          // std::uint64_t
+#include <ostream>          // std::ostream{}
+#include <algorithm>        // std::max<>()
+
+namespace bench {
+
+class latency_histogram
+{
+    static constexpr unsigned sub_bucket_bits{ 6 };
+    static constexpr unsigned sub_buckets{ 1u << sub_bucket_bits };
+    static constexpr unsigned buckets{ ( 64 - sub_bucket_bits + 1 ) * sub_buckets };
+
+    std::array< std::uint64_t, buckets > counts{};
+    std::uint64_t samples{ 0 };
+    std::uint64_t maximum{ 0 };
+
+    static unsigned index_of( std::uint64_t const ns )
+    {
+        if ( ns < sub_buckets ) return static_cast< unsigned >( ns );
+
+        unsigned const magnitude = 63 - __builtin_clzll( ns );
+        unsigned const shift = magnitude - sub_bucket_bits;
+        return ( shift + 1 ) * sub_buckets + static_cast< unsigned >( ( ns >> shift ) - sub_buckets );
+    }
+
+    static std::uint64_t upper_bound_of( unsigned const index )
+    {
+        if ( index < sub_buckets ) return index;
+
+        unsigned const shift = index / sub_buckets - 1;
+        return ( ( std::uint64_t{ index % sub_buckets } + sub_buckets + 1 ) << shift ) - 1;
+    }
+
+public:
+
+    void record( std::uint64_t const ns )
+    {
+        ++counts[ index_of( ns ) ];
+        ++samples;
+        maximum = std::max( maximum, ns );
+    }
+
+    std::uint64_t count() const { return samples; }
+    std::uint64_t max() const { return maximum; }
+
+    /// The (upper bound of the bucket holding the) given fraction's sample, in ns.
+    std::uint64_t percentile( double const fraction ) const
+    {
+        std::uint64_t const rank = static_cast< std::uint64_t >( fraction * samples );
+        std::uint64_t seen = 0;
+
+        for ( unsigned index = 0; index < buckets; ++index )
+        {
+            seen += counts[ index ];
+            if ( seen > rank ) return std::min( upper_bound_of( index ), maximum );
+        }
+
+        return maximum;
+    }
+
+    /// Write the summary as a JSON object.
+    void write_json( std::ostream& out ) const
+    {
+        out << "{ \"samples\": " << count()
+            << ", \"p50_ns\": " << percentile( 0.50 )
+            << ", \"p99_ns\": " << percentile( 0.99 )
+            << ", \"p99.9_ns\": " << percentile( 0.999 )
+            << ", \"max_ns\": " << max()
+            << " }";
+    }
+};
+
+/// Time a single call of the given operation, in nanoseconds.
+template< typename Operation >
+std::uint64_t time_ns( Operation&& operation )
+{
+    auto const start = std::chrono::steady_clock::now();
+    operation();
+    auto const finish = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( finish - start ).count();
+}
+
+} // close namespace bench
+
+#endif // INCLUDED_BENCH_LATENCY_HPP
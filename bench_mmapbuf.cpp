@@ -0,0 +1,177 @@
+#include "awo/savefmt.hpp"  // awo::savefmt{}
+#include "awo/mmapbuf.hpp"  // awo::mmapbuf{}
+
+#include <chrono>           // std::chrono::steady_clock{}
+#include <string>           // std::string{}
+#include <vector>           // std::vector<>{}
+#include <cstddef>          // std::size_t
+#include <cstdio>           // std::remove()
+#include <cstdlib>          // std::strtoul()
+#include <fstream>          // std::ofstream{}, std::ifstream{}
+#include <iomanip>          // std::setfill(), std::setw()
+#include <sstream>          // std::ostringstream{}
+#include <algorithm>        // std::min<>()
+#include <ostream>          // std::ostream{}
+#include <iterator>         // std::istreambuf_iterator<>{}
+#include <iostream>         // std::cout, std::cerr
+
+// Compares writing through std::ofstream with writing through an
+// std::ostream on an awo::mmapbuf, in three ways: a report formatted
+// line by line (which mostly times the formatting), the same report's
+// lines pre-formatted and handed over one sputn() each, and the whole
+// pre-formatted report handed over in 1 MiB sputn() blocks (these two
+// time little but the buffers themselves).
+//
+// usage: bench_mmapbuf [lines [directory]]
+
+namespace { // unnamed
+
+using clock_type = std::chrono::steady_clock;
+
+void write_line( std::ostream& out, unsigned long const line )
+{
+    out << "record " << line << ": "
+        << awo::savefmt{} << std::hex << std::uppercase << std::setfill( '0' )
+        << "0x" << std::setw( 16 ) << line * 2654435761ul
+        << '\n';
+}
+
+void write_report( std::ostream& out, unsigned long const lines )
+{
+    for ( unsigned long line = 0; line < lines; ++line )
+    {
+        write_line( out, line );
+    }
+}
+
+/// The report, pre-formatted, together with where each of its lines starts.
+struct formatted_report
+{
+    std::string text;
+    std::vector< std::size_t > line_starts;
+};
+
+formatted_report format_report( unsigned long const lines )
+{
+    std::ostringstream out;
+    formatted_report report;
+    report.line_starts.reserve( lines + 1 );
+
+    for ( unsigned long line = 0; line < lines; ++line )
+    {
+        report.line_starts.push_back( static_cast< std::size_t >( out.tellp() ) );
+        write_line( out, line );
+    }
+
+    report.text = out.str();
+    report.line_starts.push_back( report.text.size() );
+
+    return report;
+}
+
+void write_lines( std::ostream& out, formatted_report const& report )
+{
+    std::streambuf& buffer = *out.rdbuf();
+
+    for ( std::size_t line = 0; line + 1 < report.line_starts.size(); ++line )
+    {
+        std::size_t const start = report.line_starts[ line ];
+        buffer.sputn( report.text.data() + start, static_cast< std::streamsize >( report.line_starts[ line + 1 ] - start ) );
+    }
+}
+
+void write_blocks( std::ostream& out, formatted_report const& report )
+{
+    std::size_t const block = std::size_t{ 1 } << 20;
+    std::streambuf& buffer = *out.rdbuf();
+
+    for ( std::size_t start = 0; start < report.text.size(); start += block )
+    {
+        buffer.sputn( report.text.data() + start, static_cast< std::streamsize >( std::min( block, report.text.size() - start ) ) );
+    }
+}
+
+template< typename Write >
+double time_ofstream( std::string const& path, Write const& write )
+{
+    auto const start = clock_type::now();
+    {
+        std::ofstream out{ path };
+        write( out );
+    }
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+template< typename Write >
+double time_mmapbuf( std::string const& path, Write const& write )
+{
+    auto const start = clock_type::now();
+    {
+        awo::mmapbuf buffer;
+        if ( buffer.open( path.c_str() ) == nullptr )
+        {
+            throw std::ios_base::failure{ "cannot open " + path };
+        }
+
+        std::ostream out{ &buffer };
+        write( out );
+    }
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+std::string contents_of( std::string const& path )
+{
+    std::ifstream in{ path, std::ios_base::binary };
+    return { std::istreambuf_iterator< char >{ in }, std::istreambuf_iterator< char >{} };
+}
+
+/// Time one way of writing through both buffers, checking that the files match the report.
+template< typename Write >
+bool compare( char const* const name, std::string const& directory, std::string const& expected, Write const& write )
+{
+    std::string const ofstream_path = directory + "/bench_mmapbuf.ofstream";
+    std::string const mmapbuf_path  = directory + "/bench_mmapbuf.mmapbuf";
+
+    double const ofstream_seconds = time_ofstream( ofstream_path, write );
+    double const mmapbuf_seconds  = time_mmapbuf( mmapbuf_path, write );
+    bool const identical = contents_of( ofstream_path ) == expected && contents_of( mmapbuf_path ) == expected;
+
+    std::cout << name << ":" << std::endl;
+    std::cout << "  ofstream:  " << ofstream_seconds << " s" << std::endl;
+    std::cout << "  mmapbuf:   " << mmapbuf_seconds << " s" << std::endl;
+    std::cout << "  speed-up:  " << ofstream_seconds / mmapbuf_seconds << std::endl;
+    std::cout << "  identical: " << ( identical ? "yes" : "NO" ) << std::endl;
+
+    std::remove( ofstream_path.c_str() );
+    std::remove( mmapbuf_path.c_str() );
+
+    return identical;
+}
+
+} // close unnamed namespace
+
+int main( int const argc, char const* const argv[] )
+{
+    try
+    {
+        unsigned long const lines = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 0 ) : 10000000ul;
+        std::string const directory = argc > 2 ? argv[ 2 ] : "/tmp";
+        formatted_report const report = format_report( lines );
+
+        std::cout << "lines:     " << lines << " (" << report.text.size() << " bytes)" << std::endl;
+
+        bool identical = compare( "formatted report", directory, report.text,
+                                  [ lines ]( std::ostream& out ) { write_report( out, lines ); } );
+        identical = compare( "pre-formatted lines", directory, report.text,
+                             [ &report ]( std::ostream& out ) { write_lines( out, report ); } ) && identical;
+        identical = compare( "pre-formatted 1 MiB blocks", directory, report.text,
+                             [ &report ]( std::ostream& out ) { write_blocks( out, report ); } ) && identical;
+
+        return identical ? 0 : 1;
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,127 @@
+#include "awo/savefmt.hpp"  // awo::savefmt{}
+#include "awo/read_range.hpp" // awo::read_range<>()
+
+#include <chrono>           // std::chrono::steady_clock{}
+#include <string>           // std::string{}
+#include <memory>           // std::make_unique<>()
+#include <vector>           // std::vector<>{}
+#include <cstdlib>          // std::strtoul()
+#include <cstdio>           // std::remove()
+#include <fstream>          // std::ifstream{}, std::ofstream{}
+#include <sstream>          // std::istringstream{}, std::ostringstream{}
+#include <iterator>         // std::back_inserter<>()
+#include <iostream>         // std::cout, std::cerr
+
+// Compares extracting whitespace-separated numbers element-wise (a loop
+// of >> x) with extracting them by awo::read_range, from the same text:
+// hex and decimal integers (which read_range scans itself) and doubles
+// (which it hands to num_get<>, so gaining only the hoisted sentry and
+// facet look-ups).  Each is read both from a std::istringstream and,
+// through a std::filebuf, from a file in the given directory.
+//
+// usage: bench_read_range [values [directory]]
+
+namespace { // unnamed
+
+using clock_type = std::chrono::steady_clock;
+
+template< typename T >
+std::string make_text( unsigned long const values, std::ios_base& ( *radix )( std::ios_base& ) )
+{
+    std::ostringstream text;
+    text << radix;
+
+    for ( unsigned long i = 0; i < values; ++i )
+    {
+        text << static_cast< T >( i * 2654435761ul % 1000000007ul ) / T( 7 ) << ( i % 16 == 15 ? '\n' : ' ' );
+    }
+
+    return text.str();
+}
+
+template< typename T >
+double time_loop( std::istream& in, std::ios_base& ( *radix )( std::ios_base& ), std::vector< T >& values )
+{
+    auto const start = clock_type::now();
+
+    in >> radix;
+    for ( T value; in >> value; ) values.push_back( value );
+
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+template< typename T >
+double time_read_range( std::istream& in, std::ios_base& ( *radix )( std::ios_base& ), std::vector< T >& values )
+{
+    auto const start = clock_type::now();
+
+    awo::read_range< T >( in >> awo::savefmt{} >> radix, std::back_inserter( values ) );
+
+    return std::chrono::duration< double >( clock_type::now() - start ).count();
+}
+
+/// Time both ways of reading the values from streams opened afresh by the given function.
+template< typename T, typename Open >
+bool compare_from( char const* const source, unsigned long const values,
+                   std::ios_base& ( *radix )( std::ios_base& ), Open const& open )
+{
+    std::vector< T > looped, ranged;
+    looped.reserve( values );
+    ranged.reserve( values );
+
+    double const loop_seconds  = time_loop( *open(), radix, looped );
+    double const range_seconds = time_read_range( *open(), radix, ranged );
+    bool const identical = looped == ranged && looped.size() == values;
+
+    std::cout << "  " << source << ":" << std::endl;
+    std::cout << "    element-wise: " << loop_seconds << " s" << std::endl;
+    std::cout << "    read_range:   " << range_seconds << " s" << std::endl;
+    std::cout << "    speed-up:     " << loop_seconds / range_seconds << std::endl;
+    std::cout << "    identical:    " << ( identical ? "yes" : "NO" ) << std::endl;
+
+    return identical;
+}
+
+template< typename T >
+bool compare( char const* const name, unsigned long const values,
+              std::ios_base& ( *radix )( std::ios_base& ), std::string const& path )
+{
+    std::string const text = make_text< T >( values, radix );
+    std::ofstream{ path, std::ios_base::binary } << text;
+
+    std::cout << name << ":" << std::endl;
+
+    bool identical = compare_from< T >( "istringstream", values, radix,
+                                        [ &text ] { return std::make_unique< std::istringstream >( text ); } );
+    identical = compare_from< T >( "ifstream", values, radix,
+                                   [ &path ] { return std::make_unique< std::ifstream >( path, std::ios_base::binary ); } ) && identical;
+
+    std::remove( path.c_str() );
+
+    return identical;
+}
+
+} // close unnamed namespace
+
+int main( int const argc, char const* const argv[] )
+{
+    try
+    {
+        unsigned long const values = argc > 1 ? std::strtoul( argv[ 1 ], nullptr, 0 ) : 5000000ul;
+        std::string const path = std::string{ argc > 2 ? argv[ 2 ] : "/tmp" } + "/bench_read_range.txt";
+
+        std::cout << "values:   " << values << std::endl;
+
+        bool identical = compare< unsigned >( "hex unsigned", values, std::hex, path );
+        identical = compare< int >( "decimal int", values, std::dec, path ) && identical;
+        identical = compare< unsigned long long >( "decimal unsigned long long", values, std::dec, path ) && identical;
+        identical = compare< double >( "decimal double", values, std::dec, path ) && identical;
+
+        return identical ? 0 : 1;
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
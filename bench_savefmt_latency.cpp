@@ -0,0 +1,152 @@
+#include "awo/savefmt.hpp"  // awo::savefmt{}
+#include "bench_latency.hpp" // bench::latency_histogram{}, bench::time_ns<>()
+
+#include <atomic>           // std::atomic<>{}
+#include <memory>           // std::unique_ptr<>{}
+#include <string>           // std::string{}
+#include <thread>           // std::thread{}
+#include <vector>           // std::vector<>{}
+#include <cstdlib>          // std::strtoul()
+#include <cstring>          // std::strcmp()
+#include <fstream>          // std::ofstream{}
+#include <iomanip>          // std::setfill(), std::setw()
+#include <algorithm>        // std::max<>()
+#include <stdexcept>        // std::invalid_argument{}
+#include <functional>       // std::cref<>()
+#include <locale>           // std::locale{}, std::numpunct<>{}
+#include <sstream>          // std::ostringstream{}
+#include <iostream>         // std::cout, std::cerr
+
+// Records per-operation latency histograms (p50/p99/p99.9/max) for the
+// basic_savefmt operations, first on a quiet process and then while
+// background threads hammer the allocator and create/destroy locales
+// (whose reference-counts copyfmt() must also update), writing the
+// results as JSON.
+//
+// usage: bench_savefmt_latency [--iterations N] [--threads N] [--output FILE]
+
+namespace { // unnamed
+
+struct results
+{
+    bench::latency_histogram capture;
+    bench::latency_histogram restore;
+    bench::latency_histogram temporary;
+};
+
+/// Allocate and free blocks of assorted sizes until told to stop.
+void hammer_allocator( std::atomic< bool > const& stop )
+{
+    std::vector< std::unique_ptr< char[] > > blocks( 64 );
+    unsigned long next = 1;
+
+    while ( !stop.load( std::memory_order_relaxed ) )
+    {
+        next = next * 6364136223846793005ul + 1442695040888963407ul;
+        blocks[ next % blocks.size() ].reset( new char[ 16 + ( next >> 48 ) % 4096 ] );
+    }
+}
+
+/// Create and destroy locales - including copies of the measured stream's - until told to stop.
+void hammer_locales( std::atomic< bool > const& stop, std::locale const& shared )
+{
+    while ( !stop.load( std::memory_order_relaxed ) )
+    {
+        std::locale const copy{ shared };
+        std::locale const custom{ copy, new std::numpunct< char > };
+        std::locale const combined{ custom, copy, std::locale::ctype };
+    }
+}
+
+void measure( results& into, unsigned long const iterations )
+{
+    std::ostringstream stream;
+    awo::savefmt saver;
+
+    for ( unsigned long i = 0; i < iterations; ++i )
+    {
+        into.capture.record( bench::time_ns( [ & ] { saver.capture( stream ); } ) );
+
+        stream << std::hex << std::uppercase << std::setfill( '0' ) << std::setw( 8 );
+        into.restore.record( bench::time_ns( [ & ] { saver.restore(); } ) );
+        saver.release();
+
+        into.temporary.record( bench::time_ns( [ & ] {
+            stream << awo::savefmt{} << std::hex << std::uppercase << std::setfill( '0' ) << std::setw( 8 );
+        } ) );
+    }
+}
+
+results run( unsigned long const iterations, unsigned const threads )
+{
+    std::atomic< bool > stop{ false };
+    std::locale const shared{ std::ostringstream{}.getloc() };
+    std::vector< std::thread > background;
+
+    for ( unsigned t = 0; t < threads; ++t )
+    {
+        if ( t % 2 == 0 ) background.emplace_back( hammer_allocator, std::cref( stop ) );
+        else              background.emplace_back( hammer_locales, std::cref( stop ), std::cref( shared ) );
+    }
+
+    results measured;
+    measure( measured, iterations );
+
+    stop = true;
+    for ( auto& thread : background ) thread.join();
+
+    return measured;
+}
+
+void write_json( std::ostream& out, char const* const name, results const& measured, bool const last )
+{
+    out << "    \"" << name << "\": {\n";
+    out << "      \"capture\": ";   measured.capture.write_json( out );   out << ",\n";
+    out << "      \"restore\": ";   measured.restore.write_json( out );   out << ",\n";
+    out << "      \"temporary\": "; measured.temporary.write_json( out ); out << "\n";
+    out << "    }" << ( last ? "\n" : ",\n" );
+}
+
+} // close unnamed namespace
+
+int main( int const argc, char const* const argv[] )
+{
+    try
+    {
+        unsigned long iterations = 1000000;
+        unsigned threads = std::max( 3u, std::thread::hardware_concurrency() ) - 1;
+        std::string output;
+
+        for ( int arg = 1; arg + 1 < argc; arg += 2 )
+        {
+            if      ( std::strcmp( argv[ arg ], "--iterations" ) == 0 ) iterations = std::strtoul( argv[ arg + 1 ], nullptr, 0 );
+            else if ( std::strcmp( argv[ arg ], "--threads" ) == 0 )    threads = std::strtoul( argv[ arg + 1 ], nullptr, 0 );
+            else if ( std::strcmp( argv[ arg ], "--output" ) == 0 )     output = argv[ arg + 1 ];
+            else throw std::invalid_argument{ std::string{ "unknown option " } + argv[ arg ] };
+        }
+
+        results const quiet     = run( iterations, 0 );
+        results const contended = run( iterations, threads );
+
+        std::ofstream file;
+        if ( !output.empty() ) file.open( output );
+        std::ostream& out = output.empty() ? std::cout : file;
+
+        out << "{\n";
+        out << "  \"benchmark\": \"savefmt_latency\",\n";
+        out << "  \"iterations\": " << iterations << ",\n";
+        out << "  \"background_threads\": " << threads << ",\n";
+        out << "  \"results\": {\n";
+        write_json( out, "quiet", quiet, false );
+        write_json( out, "contended", contended, true );
+        out << "  }\n";
+        out << "}" << std::endl;
+
+        return out ? 0 : 1;
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -1,11 +1,60 @@
 #include "awo/savefmt.hpp"  // awo::basic_savefmt<>{} et al
+#include "awo/read_range.hpp" // awo::read_range<>()
+#include "awo/mmapbuf.hpp"  // awo::mmapbuf{}
+#include "awo/widened.hpp"  // awo::widened()
+#include "awo/savefmt_batch.hpp" // awo::savefmt_batch{}
+#include "awo/asyncbuf.hpp" // awo::asyncbuf{}
+#include "awo/formatted_view.hpp" // awo::formatted_view<>{}
 
 #include <string>           // std::basic_string<>{}, std::string{}
-#include <iomanip>          // std::setfill(), std::setw()
+#include <vector>           // std::vector<>{}
+#include <sstream>          // std::istringstream{}, std::wostringstream{}
+#include <cstdio>           // std::remove()
+#include <fstream>          // std::ifstream{}
+#include <iterator>         // std::back_inserter<>(), std::istreambuf_iterator<>{}
+#include <locale>           // std::locale{}, std::numpunct<>{}
+#include <iomanip>          // std::setfill(), std::setprecision(), std::setw()
 #include <ostream>          // std::basic_ostream<>{}, std::endl()
 #include <utility>          // std::move<>()
 #include <iostream>         // std::cerr, std::cout, std::wcout
 #include <exception>        // std::exception{}
+#include <type_traits>      // std::is_constructible<>{}, std::is_same<>{}
+
+#include <fcntl.h>          // ::open(), O_*
+#include <unistd.h>         // ::close()
+
+namespace { // unnamed
+
+/// A custom stream keeping its own formatting state (exposed via awo::format_state_traits<>).
+class report_stream : public std::ostream
+{
+public:
+
+    struct layout
+    {
+        int indent;
+        char bullet;
+        bool verbose;
+    };
+
+    layout state{ 0, '-', false };
+
+    explicit report_stream( std::streambuf* const buffer ) : std::ostream{ buffer } {}
+};
+
+} // close unnamed namespace
+
+namespace awo {
+
+template<>
+struct format_state_traits< report_stream >
+{
+    static constexpr bool is_specialized = true;
+    using state_type = report_stream::layout;
+    static state_type& state( report_stream& stream ) { return stream.state; }
+};
+
+} // close namespace awo
 
 namespace { // unnamed
 
@@ -93,6 +142,368 @@ void test_savefmt_on( std::basic_ostream< CharT >& stream )
     stream << "released: "  << 42 << std::endl;
 }
 
+template< typename T >
+void test_read_range_on( std::string const& text )
+{
+    std::istringstream bulk_stream{ text };
+    std::vector< T > bulk;
+    awo::read_range< T >( bulk_stream >> awo::savefmt{} >> std::hex, std::back_inserter( bulk ) );
+
+    std::istringstream loop_stream{ text };
+    std::vector< T > loop;
+    loop_stream >> std::hex;
+    for ( T value; loop_stream >> value; ) loop.push_back( value );
+
+    bool const matches = bulk == loop
+                      && bulk_stream.rdstate() == loop_stream.rdstate()
+                      && bulk_stream.flags() == std::istringstream{}.flags();
+
+    std::cout << "read_range( \"" << text << "\" ): " << awo::savefmt{} << std::dec << bulk.size() << " value(s), "
+              << ( matches ? "matches" : "DIFFERS FROM" ) << " element-wise extraction" << std::endl;
+}
+
+void test_read_range()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING READ_RANGE AGAINST ELEMENT-WISE EXTRACTION" << std::endl;
+
+    test_read_range_on< unsigned >( "1 2 ff 10" );
+    test_read_range_on< unsigned >( "  a b c  " );
+    test_read_range_on< unsigned >( "7 8 zz 9" );
+    test_read_range_on< int >( "7fffffff 80000000 1" );
+    test_read_range_on< short >( "-8000 -8001" );
+    test_read_range_on< double >( "" );
+    test_read_range_on< unsigned >( "-1 +2 0x1f 0X2 00x3" );
+    test_read_range_on< unsigned long long >( "ffffffffffffffff 10000000000000000 5" );
+    test_read_range_on< long >( "-8000000000000000 -8000000000000001" );
+    test_read_range_on< unsigned >( "1 0x" );
+    test_read_range_on< unsigned >( "1 2 -" );
+}
+
+void test_mmapbuf()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING MMAPBUF AGAINST OSTRINGSTREAM" << std::endl;
+
+    char const* const path = "savefmt_mmapbuf.tmp";
+    std::ostringstream expected;
+
+    {
+        awo::mmapbuf buffer;
+        std::cout << "open: " << ( buffer.open( path ) != nullptr ? "ok" : "FAILED" ) << std::endl;
+
+        std::ostream out{ &buffer };
+
+        // Enough lines to outgrow the initial mapping several times over.
+        for ( unsigned line = 0; line < 200000; ++line )
+        {
+            out      << awo::savefmt{} << std::hex << std::setw( 8 ) << line << ' ' << line << std::endl;
+            expected << awo::savefmt{} << std::hex << std::setw( 8 ) << line << ' ' << line << std::endl;
+        }
+
+        std::cout << "stream state: " << ( out ? "good" : "BAD" ) << std::endl;
+    }
+
+    std::ifstream in{ path, std::ios_base::binary };
+    std::string const written{ std::istreambuf_iterator< char >{ in }, std::istreambuf_iterator< char >{} };
+    std::remove( path );
+
+    std::cout << "file contents: " << awo::savefmt{} << std::dec << written.size() << " bytes, "
+              << ( written == expected.str() ? "identical" : "DIFFERENT" ) << std::endl;
+}
+
+void test_widened_on( std::string const& text, std::streamsize const width, std::ios_base::fmtflags const adjust )
+{
+    std::wostringstream plain;
+    plain << std::setfill( L'*' ) << std::setiosflags( adjust ) << std::setw( width ) << text.c_str() << L'|' << 42;
+
+    std::wostringstream fast;
+    fast << std::setfill( L'*' ) << std::setiosflags( adjust ) << std::setw( width ) << awo::widened( text ) << L'|' << 42;
+
+    bool const matches = plain.str() == fast.str() && plain.rdstate() == fast.rdstate();
+
+    std::cout << "widened( " << awo::savefmt{} << std::dec << text.size() << " chars, width " << width << " ): "
+              << ( matches ? "matches" : "DIFFERS FROM" ) << " narrow-string insertion" << std::endl;
+}
+
+void test_widened()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING WIDENED AGAINST NARROW-STRING INSERTION INTO A WIDE STREAM" << std::endl;
+
+    test_widened_on( "hex: 0x", 0, std::ios_base::right );
+    test_widened_on( "hex: 0x", 12, std::ios_base::right );
+    test_widened_on( "hex: 0x", 12, std::ios_base::left );
+    test_widened_on( "hex: 0x", 12, std::ios_base::internal );
+    test_widened_on( "caf\xe9", 8, std::ios_base::right );
+    test_widened_on( std::string( 1000, '7' ), 1300, std::ios_base::left );
+}
+
+void test_savefmt_batch()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING SAVEFMT_BATCH" << std::endl;
+
+    std::vector< std::ostringstream > streams( 1000 );
+    awo::savefmt_batch saver;
+    saver.reserve( streams.size() );
+
+    for ( auto& stream : streams ) saver.capture( stream );
+
+    streams[ 3 ] << std::hex << std::uppercase;
+    streams[ 64 ] << std::setfill( '0' ) << std::setw( 8 );
+    streams[ 999 ].imbue( std::locale{ std::locale::classic(), new std::numpunct< char > } );
+
+    std::size_t const restored = saver.restore();
+    std::ostringstream const fresh;
+
+    bool all_restored = true;
+    for ( auto const& stream : streams )
+    {
+        all_restored = all_restored
+                    && stream.flags() == fresh.flags()
+                    && stream.width() == fresh.width()
+                    && stream.fill() == fresh.fill()
+                    && stream.getloc() == fresh.getloc();
+    }
+
+    std::cout << "restored: " << awo::savefmt{} << std::dec << restored << " of " << saver.size() << " stream(s), "
+              << ( all_restored ? "all" : "NOT ALL" ) << " back to their saved format" << std::endl;
+    std::cout << "restored again: " << awo::savefmt{} << std::dec << saver.restore() << std::endl;
+
+    // A locale replaced by copyfmt() (which makes no imbue_event) is detected too.
+    std::ostringstream other;
+    other.imbue( std::locale{ std::locale::classic(), new std::numpunct< char > } );
+    streams[ 5 ].copyfmt( other );
+    std::size_t const copied = saver.restore();
+    std::cout << "after copyfmt: " << awo::savefmt{} << std::dec << copied << " restored, locale "
+              << ( streams[ 5 ].getloc() == fresh.getloc() ? "restored" : "NOT RESTORED" ) << std::endl;
+
+    // A savefmt's copyfmt() stamps a new epoch but leaves the locale as it was: no restore is needed.
+    for ( auto it = streams.begin(); it != streams.begin() + 100; ++it ) *it << awo::savefmt{} << std::hex << 255;
+    std::cout << "after savefmt: " << awo::savefmt{} << std::dec << saver.restore() << " of 100 stream(s) restored" << std::endl;
+
+    // A stream captured twice keeps its first snapshot, however often it is restored (as nested savers would).
+    std::ostringstream twice;
+    bool outer_dec = false;
+    std::size_t snapshots = 0, first = 0, second = 1;
+    {
+        awo::savefmt_batch nested;
+        first = nested.capture( twice );
+        twice << std::hex;
+        second = nested.capture( twice );
+        twice << std::oct;
+        nested.restore();
+        outer_dec = ( twice.flags() & std::ios_base::basefield ) == std::ios_base::dec;
+        snapshots = nested.size();
+    }
+    bool const still_dec = ( twice.flags() & std::ios_base::basefield ) == std::ios_base::dec;
+    std::cout << "captured twice: " << awo::savefmt{} << std::dec << snapshots << " snapshot(s), "
+              << ( first == second ? "same index" : "DIFFERENT INDEX" ) << ", "
+              << ( outer_dec && still_dec ? "earliest" : "LATER" ) << " snapshot restored, then left alone" << std::endl;
+}
+
+std::ostream& operator<<( std::ostream& out, report_stream::layout const& layout )
+{
+    return out << "{ indent " << layout.indent << ", bullet '" << layout.bullet << "', "
+               << ( layout.verbose ? "verbose" : "terse" ) << " }";
+}
+
+void test_format_state_traits()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING FORMAT_STATE_TRAITS ON A CUSTOM STREAM" << std::endl;
+
+    using report_savefmt = awo::savefmt_for< report_stream >;
+
+    std::cout << "savefmt_for<report_stream>: "
+              << ( std::is_same< report_savefmt, awo::state_savefmt< report_stream > >::value ? "state_savefmt" : "NOT state_savefmt" )
+              << ", savefmt_for<std::ostream>: "
+              << ( std::is_same< awo::savefmt_for< std::ostream >, awo::savefmt >::value ? "savefmt" : "NOT savefmt" )
+              << ", savefmt{ report }: "
+              << ( std::is_constructible< awo::savefmt, report_stream& >::value ? "ACCEPTED" : "refused" ) << std::endl;
+
+    std::ostringstream sink;
+    report_stream report{ sink.rdbuf() };
+
+    std::cout << awo::savefmt{} << std::dec << "initial:   " << report.state << std::endl;
+    {
+        report_savefmt const saver{ report };
+        report.state = { 4, '*', true };
+        std::cout << awo::savefmt{} << std::dec << "changed:   " << report.state << std::endl;
+    }
+    std::cout << awo::savefmt{} << std::dec << "restored:  " << report.state << std::endl;
+
+    // The temporary saver restores the block at the end of the full expression.
+    int const during = ( report << report_savefmt{} ).state.indent = 2;
+    std::cout << awo::savefmt{} << std::dec << "temporary: indent " << during << " during, " << report.state << " after" << std::endl;
+
+    report_savefmt moved{ report_savefmt{ report } };
+    report.state.indent = 8;
+    moved.restore();
+    std::cout << awo::savefmt{} << std::dec << "moved:     " << report.state << std::endl;
+
+    // The standard manipulators act on the stream's basic_ios parameters, which must be restored too.
+    {
+        report_savefmt const saver{ report };
+        report << std::hex << std::uppercase << std::setfill( '0' ) << std::setw( 8 ) << std::setprecision( 3 );
+    }
+    report << report_savefmt{} << std::hex << 255 << ' ';
+    report << 255 << ' ' << std::setw( 4 ) << 7;
+    std::ostringstream const pristine;
+    std::cout << "manipulated: \"" << sink.str() << "\", "
+              << ( report.flags() == pristine.flags() && report.fill() == ' ' && report.precision() == pristine.precision()
+                   ? "format restored" : "FORMAT NOT RESTORED" ) << std::endl;
+
+    // A changed locale is re-imbued; an unchanged one is left alone.
+    {
+        report_savefmt const saver{ report };
+        report.imbue( std::locale{ std::locale::classic(), new std::numpunct< char >{} } );
+    }
+    std::cout << "locale: " << ( report.getloc() == std::locale::classic() ? "restored" : "NOT RESTORED" ) << std::endl;
+}
+
+void test_asyncbuf()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING ASYNCBUF AGAINST OSTRINGSTREAM" << std::endl;
+
+    char const* const path = "savefmt_asyncbuf.tmp";
+    int const fd = ::open( path, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+    std::ostringstream expected;
+
+    {
+        // Small buffers, so that the writer thread is kept busy and back-pressure is exercised.
+        awo::asyncbuf buffer{ fd, 64, 2 };
+        std::ostream out{ &buffer };
+
+        for ( unsigned line = 0; line < 100000; ++line )
+        {
+            out      << awo::savefmt{} << std::hex << std::setw( 8 ) << line << ' ' << line << std::endl;
+            expected << awo::savefmt{} << std::hex << std::setw( 8 ) << line << ' ' << line << std::endl;
+        }
+
+        std::cout << "stream state: " << ( out ? "good" : "BAD" ) << std::endl;
+        std::cout << "close: " << ( buffer.close() != nullptr ? "ok" : "FAILED" ) << std::endl;
+    }
+
+    ::close( fd );
+
+    std::ifstream in{ path, std::ios_base::binary };
+    std::string const written{ std::istreambuf_iterator< char >{ in }, std::istreambuf_iterator< char >{} };
+    std::remove( path );
+
+    std::cout << "file contents: " << awo::savefmt{} << std::dec << written.size() << " bytes, "
+              << ( written == expected.str() ? "identical" : "DIFFERENT" ) << std::endl;
+}
+
+/// Apply the same insertions to a formatted_view and to a stream's own format, then compare.
+template< typename CharT, typename Insertions >
+void test_formatted_view_on( char const* const description, Insertions const& insertions )
+{
+    std::basic_ostringstream< CharT > viewed;
+    viewed << std::oct << std::setfill( CharT( '#' ) ); // the view must neither use nor change this
+    std::ios_base::fmtflags const flags_before = viewed.flags();
+
+    awo::formatted_view< CharT > view{ viewed };
+    insertions( view );
+
+    std::basic_ostringstream< CharT > expected;
+    insertions( expected );
+
+    bool const matches = viewed.str() == expected.str()
+                      && viewed.flags() == flags_before
+                      && viewed.fill() == CharT( '#' )
+                      && viewed.good();
+
+    std::cout << "formatted_view (" << sizeof( CharT ) << "-byte) " << description << ": "
+              << ( matches ? "matches" : "DIFFERS FROM" ) << " the stream's own formatting" << std::endl;
+}
+
+struct point
+{
+    int x, y;
+};
+
+/// The stream to which insertions are made (whether given the stream or a view of it).
+template< typename CharT >
+std::basic_ostream< CharT >& target_of( std::basic_ostream< CharT >& stream )
+{
+    return stream;
+}
+
+template< typename CharT >
+std::basic_ostream< CharT >& target_of( awo::formatted_view< CharT >& view )
+{
+    return view.stream();
+}
+
+template< typename Stream >
+Stream& operator<<( Stream& out, point const& p )
+{
+    return out << '(' << p.x << ", " << p.y << ')';
+}
+
+void test_formatted_view()
+{
+    std::cout << std::endl;
+    std::cout << "TESTING FORMATTED_VIEW AGAINST STREAM FORMATTING" << std::endl;
+
+    auto const integers = []( auto& out )
+    {
+        out << 0 << ' ' << -42 << ' ' << std::showpos << 42 << ' ' << 42u << std::noshowpos << ' '
+            << std::hex << std::showbase << 255 << ' ' << -1 << ' ' << std::uppercase << 0xBEEFul << ' ' << 0 << ' '
+            << std::oct << 8 << ' ' << std::dec << std::noshowbase << std::nouppercase
+            << ( -9223372036854775807ll - 1 ) << ' ' << 18446744073709551615ull << ' '
+            << static_cast< short >( -7 ) << ' ' << static_cast< unsigned char >( 'u' );
+    };
+
+    auto const padding = []( auto& out )
+    {
+        using char_type = decltype( out.fill() );
+
+        out << std::setfill( char_type( '*' ) ) << '[' << std::setw( 6 ) << -42 << ']'
+            << '[' << std::left << std::setw( 6 ) << -42 << ']'
+            << '[' << std::internal << std::setw( 6 ) << -42 << ']'
+            << '[' << std::hex << std::showbase << std::setw( 8 ) << 255 << ']'
+            << '[' << std::right << std::setw( 8 ) << "text" << ']'
+            << '[' << std::left << std::setw( 3 ) << 'c' << ']'
+            << '[' << std::setw( 2 ) << "longer" << ']' << 7
+            << '[' << std::right << std::oct << std::internal << std::setw( 6 ) << 8 << ']'
+            << '[' << std::setw( 6 ) << 0 << ']' << std::dec << std::noshowbase;
+    };
+
+    auto const others = []( auto& out )
+    {
+        using char_type = decltype( out.fill() );
+        char const* const text = "string";
+
+        out << 3.14159265 << ' ' << std::setprecision( 3 ) << 2.0 / 3 << ' ' << std::fixed << 1e6 << ' '
+            << std::scientific << std::uppercase << 12345.678 << ' ' << true << ' ' << std::boolalpha << false << ' '
+            << std::basic_string< char_type >( text, text + 6 ) << ' ' << point{ 3, -4 } << std::endl;
+    };
+
+    // Manipulators take effect even while the stream is failed (and nothing is written).
+    auto const failed = []( auto& out )
+    {
+        using char_type = decltype( out.fill() );
+
+        target_of( out ).setstate( std::ios_base::failbit );
+        out << std::hex << std::uppercase << std::setfill( char_type( '0' ) ) << std::setw( 6 ) << 255 << "lost";
+        target_of( out ).clear();
+        out << 255 << ' ' << std::setprecision( 2 ) << std::setiosflags( std::ios_base::fixed ) << 1.0 / 3;
+    };
+
+    test_formatted_view_on< char >( "integers", integers );
+    test_formatted_view_on< char >( "padding", padding );
+    test_formatted_view_on< char >( "others", others );
+    test_formatted_view_on< char >( "failed", failed );
+    test_formatted_view_on< wchar_t >( "integers", integers );
+    test_formatted_view_on< wchar_t >( "padding", padding );
+    test_formatted_view_on< wchar_t >( "others", others );
+    test_formatted_view_on< wchar_t >( "failed", failed );
+}
+
 } // close unnamed namespace
 
 int main()
@@ -107,6 +518,14 @@ int main()
 
         test_savefmt_on( std::cout );
         test_savefmt_on( std::wcout );
+
+        test_read_range();
+        test_mmapbuf();
+        test_widened();
+        test_savefmt_batch();
+        test_format_state_traits();
+        test_asyncbuf();
+        test_formatted_view();
     }
     catch ( std::exception const& e )
     {